@@ -0,0 +1,158 @@
+#define QUEENS_STATS // 打开 queens.h 中的节点计数
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "queens.h"
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// N皇后各种求解方法的基准测试
+// 对每个N、每种方法记录：耗时、扩展节点数、解数、每秒解数/节点数、峰值内存，并与已知解数核对
+
+// n = 1..18 的解数
+static const long long known[] = {1, 0, 0, 2, 10, 4, 40, 92, 352, 724, 2680, 14200, 73712,
+                                  365596, 2279184, 14772512, 95815104, 666090624};
+
+int threads = 0; // parallel 方法使用的线程数，0表示全部核心
+
+typedef struct strategy_t
+{
+    const char *name;
+    int max_n; // 超过此N不运行（朴素枚举是 n^n）
+    long long (*run)(int n);
+} strategy_t;
+
+static const strategy_t strategies[] = {
+    {"naive", 8, [](int n)
+     { return queens_count_naive(n); }},
+    {"bfs", QUEENS_MAX_N, [](int n)
+     { return queens_bfs(n, (size_t)256 << 20, [](const int *) {}); }},
+    {"dfs", QUEENS_MAX_N, [](int n)
+     { return queens_count(n); }},
+    {"kernel", QUEENS_MAX_N, [](int n)
+     { return queens_solve_fixed(n, false, [](const int *) {}); }},
+    {"sym", QUEENS_MAX_N, [](int n)
+     { return queens_count_sym(n, NULL); }},
+    {"parallel", QUEENS_MAX_N, [](int n)
+     { return queens_count_parallel(n, threads); }},
+};
+
+typedef struct result_t
+{
+    double seconds;
+    long long nodes, solutions;
+    long peak_rss_kb; // 该次运行的峰值常驻内存，无法测量时为-1
+} result_t;
+
+// 在当前进程中运行一次并计时
+result_t measure(const strategy_t &s, int n)
+{
+    result_t r;
+    queens_nodes_total = 0;
+    queens_nodes = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    r.solutions = s.run(n);
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    r.nodes = queens_nodes_total + queens_nodes;
+    r.peak_rss_kb = -1;
+    return r;
+}
+
+// 每次运行放在单独的子进程里，这样峰值内存只反映这一种方法，也不受前面运行的影响
+result_t run_isolated(const strategy_t &s, int n)
+{
+#ifdef _WIN32
+    return measure(s, n);
+#else
+    int fd[2];
+    if (pipe(fd) != 0)
+        return measure(s, n);
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        close(fd[0]);
+        result_t r = measure(s, n);
+        ssize_t w = write(fd[1], &r, sizeof r);
+        (void)w;
+        _exit(0);
+    }
+    close(fd[1]);
+    result_t r = {0, 0, -1, -1};
+    ssize_t got = read(fd[0], &r, sizeof r);
+    close(fd[0]);
+    int status;
+    struct rusage ru;
+    wait4(pid, &status, 0, &ru);
+    if (got != (ssize_t)sizeof r)
+        r.solutions = -1;
+    r.peak_rss_kb = ru.ru_maxrss; // Linux 下单位为KB
+    return r;
+#endif
+}
+
+// 用法: Queens-Bench [-from 4] [-to 16] [-only name] [-t threads] [-json]
+int main(int argc, char *argv[])
+{
+    int from = 4, to = 16;
+    const char *only = NULL;
+    bool json = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-from") == 0 && i + 1 < argc)
+            from = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-to") == 0 && i + 1 < argc)
+            to = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-only") == 0 && i + 1 < argc)
+            only = argv[++i];
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-json") == 0)
+            json = true;
+    }
+    if (from < 1)
+        from = 1;
+    if (to > QUEENS_MAX_N)
+        to = QUEENS_MAX_N;
+
+    int failures = 0;
+    bool first = true;
+    if (json)
+        printf("[\n");
+    else
+        printf("strategy,n,seconds,nodes,solutions,solutions_per_sec,nodes_per_sec,peak_rss_kb,check\n");
+    for (int n = from; n <= to; n++)
+    {
+        for (const strategy_t &s : strategies)
+        {
+            if (n > s.max_n || (only && strcmp(only, s.name) != 0))
+                continue;
+            result_t r = run_isolated(s, n);
+            double sec = r.seconds > 0 ? r.seconds : 1e-9;
+            const char *check = "unknown";
+            if (n <= (int)(sizeof known / sizeof known[0]))
+                check = r.solutions == known[n - 1] ? "ok" : "FAIL";
+            if (strcmp(check, "FAIL") == 0)
+                failures++;
+            if (json)
+            {
+                printf("%s  {\"strategy\": \"%s\", \"n\": %d, \"seconds\": %.6f, \"nodes\": %lld, \"solutions\": %lld, "
+                       "\"solutions_per_sec\": %.0f, \"nodes_per_sec\": %.0f, \"peak_rss_kb\": %ld, \"check\": \"%s\"}",
+                       first ? "" : ",\n", s.name, n, r.seconds, r.nodes, r.solutions,
+                       r.solutions / sec, r.nodes / sec, r.peak_rss_kb, check);
+                first = false;
+            }
+            else
+                printf("%s,%d,%.6f,%lld,%lld,%.0f,%.0f,%ld,%s\n", s.name, n, r.seconds, r.nodes, r.solutions,
+                       r.solutions / sec, r.nodes / sec, r.peak_rss_kb, check);
+            fflush(stdout);
+        }
+    }
+    if (json)
+        printf("\n]\n");
+    return failures ? 1 : 0;
+}
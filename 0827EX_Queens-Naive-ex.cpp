@@ -1,5 +1,7 @@
 #include <iostream>
 #include <stdlib.h>
+#include <string.h>
+#include "queens.h"
 
 using namespace std;
 
@@ -23,8 +25,32 @@ bool isValid(int i1, int i2, int i3, int i4, int i5, int i6, int i7, int i8) {
     return true; // 没有冲突，合法
 }
 
-int main(int argc, char *argv[])
-{
+// 多线程版本：前两列(i1,i2)的64种组合作为任务，由工作窃取线程池分给所有核心，只计数不输出
+long long parallelCount(int threads) {
+    struct task_t { int i1, i2; };
+    std::vector<task_t> tasks;
+    for (int i1 = 1; i1 <= 8; i1++)
+        for (int i2 = 1; i2 <= 8; i2++)
+            tasks.push_back({i1, i2});
+    if (threads <= 0)
+        threads = (int)std::thread::hardware_concurrency();
+    ws_pool_t<task_t> pool(threads);
+    return pool.run(tasks, [](int, const task_t &t) -> long long {
+        long long cnt = 0;
+        for(int i3=1;i3<=8;i3++)
+            for(int i4=1;i4<=8;i4++)
+                for(int i5=1;i5<=8;i5++)
+                    for(int i6=1;i6<=8;i6++)
+                        for(int i7=1;i7<=8;i7++)
+                            for(int i8=1;i8<=8;i8++)
+                                if(isValid(t.i1,t.i2,i3,i4,i5,i6,i7,i8))
+                                    cnt++;
+        return cnt;
+    });
+}
+
+// 原始的8重循环基线：枚举8^8种组合再整体判断，保留用于对比
+int loopsSolve(bool countOnly, qwriter_t *out) {
     int Num = 0; // 记录解的个数
     // 8重循环，枚举每一列皇后所在的行
     for(int i1=1;i1<=8;i1++){
@@ -38,8 +64,14 @@ int main(int argc, char *argv[])
                                     // 检查当前摆法是否合法
                                     if(isValid(i1,i2,i3,i4,i5,i6,i7,i8)){
                                         Num++; // 合法解+1
+                                        if (countOnly)
+                                            continue;
                                         // 输出当前解
-                                        printf("solution %d: %d %d %d %d %d %d %d %d\n", Num, i1, i2, i3, i4, i5, i6, i7, i8);
+                                        if (out) {
+                                            int q[8] = {i1 - 1, i2 - 1, i3 - 1, i4 - 1, i5 - 1, i6 - 1, i7 - 1, i8 - 1};
+                                            out->put(8, q);
+                                        } else
+                                            printf("solution %d: %d %d %d %d %d %d %d %d\n", Num, i1, i2, i3, i4, i5, i6, i7, i8);
                                     }
                                 }
                             }
@@ -50,5 +82,76 @@ int main(int argc, char *argv[])
         }
     }
 
+    return Num;
+}
+
+// 用法: Queens-Naive [-n N] [-loops] [-t threads] [--count-only] [-o file [-text]]
+// -n           棋盘大小（默认8），4~16使用 queens.h 中编译期特化的 Queens<N>，其余使用运行时版本
+// -loops       使用原始的8重循环（只支持N=8）
+// -t           多线程计数，threads=0 表示使用全部核心
+// --count-only 只计数，不格式化输出
+// -o           解成块写入文件：默认每个解N字节（第k字节为第k列皇后的行号，从0开始），-text 时每行一个字符串
+int main(int argc, char *argv[])
+{
+    int n = 8, threads = -1;
+    bool countOnly = false, loops = false;
+    const char *outPath = NULL;
+    qwrite_fmt_t fmt = QW_BINARY;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            n = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-loops") == 0)
+            loops = true;
+        else if (strcmp(argv[i], "--count-only") == 0)
+            countOnly = true;
+        else if (strcmp(argv[i], "-text") == 0)
+            fmt = QW_TEXT;
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            outPath = argv[++i];
+    }
+    if (n < 1 || n > QUEENS_MAX_N || (loops && n != 8)) {
+        printf("n must be in [1, %d] (8 with -loops)\n", QUEENS_MAX_N);
+        return 1;
+    }
+    if (threads >= 0) {
+        printf("Total solutions: %lld\n", loops ? parallelCount(threads) : queens_count_parallel(n, threads));
+        return 0;
+    }
+    FILE *fp = NULL;
+    if (outPath && !(fp = fopen(outPath, fmt == QW_BINARY ? "wb" : "w"))) {
+        printf("cannot open %s\n", outPath);
+        return 1;
+    }
+    qwriter_t *out = fp ? new qwriter_t(fp, fmt) : NULL;
+
+    long long Num;
+    if (loops)
+        Num = loopsSolve(countOnly, out);
+    else {
+        long long k = 0;
+        Num = queens_solve_fixed(n, !countOnly, [&](const int *q) {
+            if (out) {
+                out->put(n, q);
+                return;
+            }
+            printf("solution %lld:", ++k);
+            for (int r = 0; r < n; r++)
+                printf(" %d", q[r] + 1);
+            printf("\n");
+        });
+    }
+
+    if (out) {
+        bool ok = out->finish();
+        delete out;
+        if (fclose(fp) != 0 || !ok) {
+            printf("write to %s failed\n", outPath);
+            return 1;
+        }
+    }
+    if (countOnly || out)
+        printf("Total solutions: %lld\n", Num);
     return 0;
 }
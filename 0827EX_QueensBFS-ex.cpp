@@ -1,30 +1,186 @@
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include "queens.h"
 
-#define MAX_N 8
-#define MAX_NODES 10000 * MAX_N
-
-#define put_node(st) queue[tl++] = st
-#define get_node() queue[hd++]
-#define queue_not_empty (hd < tl)
+#define DEFAULT_MEM_MB 256 // BFS层缓冲区默认内存上限
 
 typedef struct state_t
 {
-    short n, q[MAX_N]; // n表示已经放置的皇后数量，q数组存储每行皇后的列位置
+    short n, q[QUEENS_MAX_N]; // n表示已经放置的皇后数量，q数组存储每行皇后的列位置
 } state_t;
 
-state_t queue[MAX_NODES];
-int hd = 0, tl = 0;
+int show_board = 1; // 打印解时是否画出棋盘
 
-int conflict(int row, int col, short queens[]); // 检查(row,col)位置是否冲突
-int queen(int n);                               // 解决n皇后问题
-void print_queens(state_t *st);                 // 打印皇后的位置
+long long queen(int n, size_t mem_bytes, qwriter_t *out); // 解决n皇后问题，out非空时写入文件而不打印
+void print_queens(state_t *st);                           // 打印皇后的位置
+void emit(int n, const int *q, qwriter_t *out);           // 输出一个解
+int local_search(int n, uint64_t seed, const char *out_path, qwrite_fmt_t fmt); // 局部搜索求一个解
 
-int main()
+// 用法: QueensBFS [n] [-count] [-t threads] [-sym] [-unique] [-mem MB] [-brief] [-o file [-text]] [-local [-seed s]]
+//                 [-ckpt file [-k rows] [-range a:b]] [-merge file...] [-fix r,c ... [-first]]
+// -count  只用位运算DFS计数，不做BFS也不打印（也可写作 --count-only）
+// -t      多线程计数（工作窃取），threads=0 表示使用全部核心
+// -sym    利用8种旋转/翻转对称只搜索代表解，输出总数和本质不同解数
+// -unique 同 -sym，并打印每个本质不同的解
+// -mem    BFS两个层缓冲区的内存上限(MB)，超出后剩余部分改用DFS
+// -brief  只打印解的坐标，不画棋盘
+// -o      解成块写入文件：默认每个解n字节的二进制记录，-text 时每行一个32进制字符串
+// -local  最小冲突局部搜索只求一个解，n不受32的限制；n>32时 -o 文件中每行一个列号
+// -ckpt   按前k行（默认4）拆成编号任务计数，完成的任务定期写入断点文件，重启时从文件继续
+// -range  只计算任务号 [a, b)，可以用多个进程各算一段，配合 -t 指定每个进程的线程数
+// -merge  合并多个断点文件，所有任务齐全时输出总数
+// -fix    固定第r行皇后在第c列（可多次给出），只搜索其余行；-first 时输出第一个补全，否则统计补全数
+int main(int argc, char *argv[])
 {
-    queen(MAX_N);
+    int n = 8, threads = -1;
+    size_t mem_mb = DEFAULT_MEM_MB;
+    bool count_only = false, sym = false, unique = false, local = false;
+    uint64_t seed = 1;
+    const char *out_path = NULL, *ckpt_path = NULL;
+    qwrite_fmt_t fmt = QW_BINARY;
+    int prefix_rows = 4, first = 0, last = -1;
+    std::vector<const char *> merge_paths;
+    std::vector<std::pair<int, int>> fixed;
+    bool first_only = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-count") == 0 || strcmp(argv[i], "--count-only") == 0)
+            count_only = true;
+        else if (strcmp(argv[i], "-brief") == 0)
+            show_board = 0;
+        else if (strcmp(argv[i], "-text") == 0)
+            fmt = QW_TEXT;
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            out_path = argv[++i];
+        else if (strcmp(argv[i], "-local") == 0)
+            local = true;
+        else if (strcmp(argv[i], "-seed") == 0 && i + 1 < argc)
+            seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-ckpt") == 0 && i + 1 < argc)
+            ckpt_path = argv[++i];
+        else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc)
+            prefix_rows = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-range") == 0 && i + 1 < argc)
+            sscanf(argv[++i], "%d:%d", &first, &last);
+        else if (strcmp(argv[i], "-fix") == 0 && i + 1 < argc)
+        {
+            int r, c;
+            if (sscanf(argv[++i], "%d,%d", &r, &c) == 2)
+                fixed.push_back({r, c});
+        }
+        else if (strcmp(argv[i], "-first") == 0)
+            first_only = true;
+        else if (strcmp(argv[i], "-merge") == 0)
+        {
+            while (i + 1 < argc)
+                merge_paths.push_back(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-sym") == 0)
+            sym = true;
+        else if (strcmp(argv[i], "-unique") == 0)
+            sym = unique = true;
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-mem") == 0 && i + 1 < argc)
+            mem_mb = strtoull(argv[++i], NULL, 10);
+        else
+            n = atoi(argv[i]);
+    }
+    if (local)
+        return local_search(n, seed, out_path, fmt);
+    if (!merge_paths.empty())
+    {
+        int missing = 0;
+        long long total = queens_merge(merge_paths, &missing);
+        if (total < 0)
+        {
+            printf("checkpoint files do not match or %d tasks are missing\n", missing);
+            return 1;
+        }
+        printf("Total solutions: %lld\n", total);
+        return 0;
+    }
+    if (n < 1 || n > QUEENS_MAX_N)
+    {
+        printf("n must be in [1, %d]\n", QUEENS_MAX_N);
+        return 1;
+    }
+    FILE *fp = NULL;
+    if (out_path && !(fp = fopen(out_path, fmt == QW_BINARY ? "wb" : "w")))
+    {
+        printf("cannot open %s\n", out_path);
+        return 1;
+    }
+    qwriter_t *out = fp ? new qwriter_t(fp, fmt) : NULL;
+
+    if (!fixed.empty())
+    {
+        int q[QUEENS_MAX_N];
+        long long cnt = queens_complete(n, fixed, first_only, q);
+        if (cnt < 0)
+            printf("fixed queens attack each other\n");
+        else if (first_only && cnt)
+            emit(n, q, out);
+        else
+            printf("Completions for %d-queens problem: %lld\n", n, cnt);
+    }
+    else if (ckpt_path)
+    {
+        long long total = queens_count_checkpoint(n, prefix_rows, ckpt_path, first, last, threads);
+        if (total < 0)
+        {
+            printf("checkpoint %s does not match n=%d k=%d or cannot be written\n", ckpt_path, n, prefix_rows);
+            return 1;
+        }
+        if (first == 0 && last < 0)
+            printf("Total solutions for %d-queens problem: %lld\n", n, total);
+        else
+            printf("Solutions for tasks [%d, %d): %lld\n", first, last, total);
+    }
+    else if (sym)
+    {
+        long long nUnique;
+        long long total = queens_count_sym(n, &nUnique, [&](const int *q)
+                                           {
+            if (unique)
+                emit(n, q, out); });
+        printf("Total solutions for %d-queens problem: %lld (unique: %lld)\n", n, total, nUnique);
+    }
+    else if (threads >= 0)
+        printf("Total solutions for %d-queens problem: %lld\n", n, queens_count_parallel(n, threads));
+    else if (count_only)
+        printf("Total solutions for %d-queens problem: %lld\n", n, queens_count(n));
+    else
+        queen(n, mem_mb << 20, out);
+
+    if (out)
+    {
+        bool ok = out->finish();
+        delete out;
+        if (fclose(fp) != 0 || !ok)
+        {
+            printf("write to %s failed\n", out_path);
+            return 1;
+        }
+    }
     return 0;
 }
 
+void emit(int n, const int *q, qwriter_t *out)
+{
+    if (out)
+    {
+        out->put(n, q);
+        return;
+    }
+    state_t st;
+    st.n = n;
+    for (int i = 0; i < n; i++)
+        st.q[i] = q[i];
+    print_queens(&st);
+}
+
 void print_queens(state_t *st)
 {
     printf("Solution: ");
@@ -33,6 +189,8 @@ void print_queens(state_t *st)
         printf("(%d,%d) ", i, st->q[i]);
     }
     printf("\n");
+    if (!show_board)
+        return;
 
     // 可选：打印棋盘图形
     for (int i = 0; i < st->n; i++)
@@ -53,58 +211,49 @@ void print_queens(state_t *st)
     printf("\n");
 }
 
-// 检查在第row行第col列放置皇后是否与之前的皇后冲突
-int conflict(int row, int col, short queens[])
+long long queen(int n, size_t mem_bytes, qwriter_t *out)
 {
-    for (int i = 0; i < row; i++)
-    {
-        // 检查同一列
-        if (queens[i] == col)
-        {
-            return 1;
-        }
-        // 检查对角线：行差 == 列差
-        if (abs(queens[i] - col) == abs(i - row))
-        {
-            return 1;
-        }
-    }
-    return 0;
+    // 逐层BFS：每层状态压缩存放在两个交替使用的缓冲区中，由 queens_bfs 负责扩展和内存上限
+    long long nCount = queens_bfs(n, mem_bytes, [&](const int *q)
+                                  { emit(n, q, out); });
+
+    printf("Total solutions for %d-queens problem: %lld\n", n, nCount);
+    return nCount;
 }
 
-int queen(int n)
+int local_search(int n, uint64_t seed, const char *out_path, qwrite_fmt_t fmt)
 {
-    int nCount = 0;
-    state_t st;
-
-    // 初始化：放置第一个皇后
-    st.n = 0;
-    put_node(st);
-
-    while (queue_not_empty)
+    std::vector<int> q;
+    long long steps = 0;
+    if (!queens_min_conflicts(n, q, seed, &steps))
     {
-        st = get_node();
-
-        if (st.n >= n)
-        {
-            print_queens(&st);
-            nCount++;
-            continue;
-        }
-
-        // 尝试在当前行的每一列放置皇后
-        for (int i = 0; i < n; i++)
-        {
-            if (!conflict(st.n, i, st.q))
-            {
-                state_t new_st = st;
-                new_st.q[new_st.n] = i; // 在当前行的第i列放置皇后
-                new_st.n++;             // 移动到下一行
-                put_node(new_st);
-            }
-        }
+        printf("No solution found for %d-queens problem\n", n);
+        return 1;
     }
-
-    printf("Total solutions for %d-queens problem: %d\n", n, nCount);
-    return nCount;
-}
\ No newline at end of file
+    FILE *fp = NULL;
+    if (out_path && !(fp = fopen(out_path, fmt == QW_BINARY && n <= QUEENS_MAX_N ? "wb" : "w")))
+    {
+        printf("cannot open %s\n", out_path);
+        return 1;
+    }
+    bool ok = true;
+    if (n <= QUEENS_MAX_N)
+    {
+        qwriter_t *out = fp ? new qwriter_t(fp, fmt) : NULL;
+        emit(n, q.data(), out);
+        ok = !out || out->finish();
+        delete out;
+    }
+    else if (fp)
+    {
+        for (int r = 0; r < n; r++)
+            ok = fprintf(fp, "%d\n", q[r]) > 0 && ok;
+    }
+    if (fp && (fclose(fp) != 0 || !ok))
+    {
+        printf("write to %s failed\n", out_path);
+        return 1;
+    }
+    printf("Found a solution for %d-queens problem (%lld swaps tried)\n", n, steps);
+    return 0;
+}
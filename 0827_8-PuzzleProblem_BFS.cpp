@@ -1,123 +1,173 @@
-#include <bits/stdc++.h>
-using namespace std;
+#include "puzzle.h"
 
-struct Board
+// BFS，找到时把解写成移动串放进 moves；expanded 非空时累加扩展的节点数
+bool bfs(Board start, Board goal, string &moves, long long *expanded = NULL)
 {
-    string s;
-    Board(string t = "1238_4765") : s(t) {}
-    int blank_pos() const { return (int)s.find('_'); }
-    bool operator==(const Board &o) const { return s == o.s; }
-    vector<Board> neighbors() const
+    moves.clear();
+    if (start == goal)
+        return true;
+    queue<Board> q;
+    VisitedBits vis;   // 按排列编号的访问位，共 9!/8 字节
+    MoveArray parent;  // 到达每个状态的移动方向，共 9!/4 字节
+    q.push(start);
+    vis.insert(board_rank(start));
+    while (!q.empty())
     {
-        static int dr[4] = {-1, 1, 0, 0}, dc[4] = {0, 0, -1, 1};
-        vector<Board> res;
-        int z = blank_pos(), r = z / 3, c = z % 3;
+        Board u = q.front();
+        q.pop();
+        if (expanded)
+            (*expanded)++;
         for (int k = 0; k < 4; k++)
         {
-            int nr = r + dr[k], nc = c + dc[k];
-            if (nr < 0 || nr >= 3 || nc < 0 || nc >= 3)
+            int nz = u.target(k);
+            if (nz < 0)
                 continue;
-            int nz = nr * 3 + nc;
-            Board nb = *this;
-            swap(nb.s[z], nb.s[nz]);
-            res.push_back(nb);
-        }
-        return res;
-    }
-    string to_grid() const
-    {
-        string out;
-        for (int i = 0; i < 9; i++)
-        {
-            out.push_back(s[i]);
-            if (i % 3 != 2)
-                out.push_back(' ');
-            if (i % 3 == 2 && i != 8)
-                out.push_back('\n');
+            Board v = u.moved(nz);
+            uint32_t rv = board_rank(v);
+            if (vis.insert(rv))
+            {
+                parent.set(rv, k);
+                if (v == goal)
+                {
+                    moves = reconstruct_moves(start, v, parent);
+                    return true;
+                }
+                q.push(v);
+            }
         }
-        return out;
     }
-};
-
-// 可达性判定
-int inversion_count(const string &x)
-{
-    vector<char> a;
-    for (char ch : x)
-        if (ch != '_')
-            a.push_back(ch);
-    int inv = 0;
-    for (int i = 0; i < (int)a.size(); i++)
-        for (int j = i + 1; j < (int)a.size(); j++)
-            if (a[i] > a[j])
-                inv++;
-    return inv;
-}
-bool solvable(const Board &s, const Board &g)
-{
-    return inversion_count(s.s) % 2 == inversion_count(g.s) % 2;
+    return false;
 }
 
-// 回溯路径
-vector<Board> reconstruct(const Board &goal, unordered_map<string, string> &parent)
+// 从 s 沿 parent 记录的方向回退到 root 需要的步数
+int tree_depth(Board s, const Board &root, const MoveArray &parent)
 {
-    vector<Board> seq;
-    string cur = goal.s;
-    while (!cur.empty())
-    {
-        seq.push_back(Board(cur));
-        if (!parent.count(cur))
-            break;
-        cur = parent[cur];
-    }
-    reverse(seq.begin(), seq.end());
-    return seq;
+    int d = 0;
+    for (; !(s == root); d++)
+        s = s.moved(s.target(parent.get(board_rank(s)) ^ 1));
+    return d;
 }
 
-// BFS
-vector<Board> bfs(Board start, Board goal)
+// 双向BFS：start、goal 两边各有一棵搜索树，每次把较小的一边整层扩展一次。
+// 新生成的状态如果已被另一边访问过就是相遇点；整层扩展完后取另一边深度最小的相遇点，
+// 保证拼出的路径最短。
+vector<Board> bibfs(Board start, Board goal, long long *expanded = NULL)
 {
     if (start == goal)
         return vector<Board>(1, start);
-    queue<Board> q;
-    unordered_set<string> vis;
-    unordered_map<string, string> parent;
-    q.push(start);
-    vis.insert(start.s);
-    while (!q.empty())
+    const Board root[2] = {start, goal};
+    VisitedBits vis[2];
+    MoveArray parent[2];
+    vector<Board> front[2], next;
+    for (int s = 0; s < 2; s++)
     {
-        Board u = q.front();
-        q.pop();
-        for (auto v : u.neighbors())
+        vis[s].insert(board_rank(root[s]));
+        front[s].push_back(root[s]);
+    }
+    while (!front[0].empty() && !front[1].empty())
+    {
+        int s = front[0].size() <= front[1].size() ? 0 : 1, o = 1 - s;
+        next.clear();
+        int best = INT_MAX;
+        Board meet;
+        for (const Board &u : front[s])
         {
-            if (!vis.count(v.s))
+            if (expanded)
+                (*expanded)++;
+            for (int k = 0; k < 4; k++)
             {
-                vis.insert(v.s);
-                parent[v.s] = u.s;
-                if (v == goal)
-                    return reconstruct(v, parent);
-                q.push(v);
+                int nz = u.target(k);
+                if (nz < 0)
+                    continue;
+                Board v = u.moved(nz);
+                uint32_t rv = board_rank(v);
+                if (!vis[s].insert(rv))
+                    continue;
+                parent[s].set(rv, k);
+                if (vis[o].test(rv))
+                {
+                    int d = tree_depth(v, root[o], parent[o]);
+                    if (d < best)
+                        best = d, meet = v;
+                }
+                next.push_back(v);
             }
         }
+        if (best < INT_MAX)
+        {
+            // start→meet 加上 meet→goal（goal 一侧的树回溯出来是 goal→meet，需要反过来）
+            vector<Board> a = reconstruct(start, meet, parent[0]);
+            vector<Board> b = reconstruct(goal, meet, parent[1]);
+            a.insert(a.end(), b.rbegin() + 1, b.rend());
+            return a;
+        }
+        front[s].swap(next);
     }
     return vector<Board>();
 }
 
-// 打印路径
-void print_path(const vector<Board> &path)
+// 多线程逐层BFS：状态空间为完整的 9! 排列，按层扩展直到目标被访问
+vector<Board> parallel_bfs(Board start, Board goal, int threads, long long *expanded = NULL)
 {
-    for (int i = 0; i < (int)path.size(); i++)
-    {
-        cout << "Step " << i << ":\n"
-             << path[i].to_grid() << "\n\n";
-    }
+    PartialSpace<3, 3> space({1, 2, 3, 4, 5, 6, 7, 8}, goal);
+    ParallelBfs<PartialSpace<3, 3>> search(space, threads);
+    uint32_t rg = space.rank(goal);
+    uint64_t n = search.run(space.rank(start), -1, rg);
+    if (expanded)
+        *expanded += (long long)n;
+    vector<Board> path;
+    if (!search.vis.test(rg))
+        return path;
+    for (uint32_t r : search.path(rg))
+        path.push_back(space.board(r));
+    return path;
 }
 
-int main()
+// 用法: 8-PuzzleProblem_BFS [-goal G] [-bi | -t threads | -frontier | -table | -db file] [-grid] [初始状态...]
+// -goal  目标状态，默认 "1238_4765"
+// -bi    使用双向BFS
+// -t     多线程逐层BFS，threads=0 表示使用全部核心
+// -frontier 前沿搜索：不保留已访问集合，内存只有相邻两层，路径用中点分治求出
+// -table 先从目标做一次BFS建立全部状态的距离表，之后每个查询只沿距离表下降
+// -db    从文件映射距离表；文件不存在、与目标不符或校验和不符时先建表，写临时文件后 rename 替换，不影响正在映射旧文件的进程
+//        -table/-db 的距离表总是按规范目标建立，任意目标通过重编号映射过去，所以一张表可服务多个目标
+// -grid  除移动串外，重放并打印每一步的棋盘
+// 不给初始状态时求解默认的6个状态；解输出为空格的移动串（U上 D下 L左 R右）
+int main(int argc, char *argv[])
 {
     system("chcp 65001 > nul");
 
+    bool bidirectional = false, use_table = false, grid = false, frontier = false;
+    int threads = -1;
+    const char *db_path = NULL, *goal_arg = "1238_4765";
+    vector<Board> queries;
     Board goal("1238_4765"); // 新目标状态
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-bi") == 0)
+            bidirectional = true;
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-frontier") == 0)
+            frontier = true;
+        else if (strcmp(argv[i], "-grid") == 0)
+            grid = true;
+        else if (strcmp(argv[i], "-table") == 0)
+            use_table = true;
+        else if (strcmp(argv[i], "-db") == 0 && i + 1 < argc)
+            db_path = argv[++i];
+        else if (strcmp(argv[i], "-goal") == 0 && i + 1 < argc)
+            goal = Board(goal_arg = argv[++i]);
+        else
+        {
+            queries.push_back(Board(argv[i]));
+            if (!queries.back().valid())
+            {
+                cerr << "初始状态不合法: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+    }
 
     // 6个初始状态
     vector<Board> states = {
@@ -128,8 +178,42 @@ int main()
         Board("1234_6758"), // State5
         Board("152_34678")  // State6
     };
+    if (!queries.empty())
+        states = queries;
 
-    for (int i = 0; i < 6; i++)
+    if (!goal.valid())
+    {
+        cerr << "目标状态不合法: " << goal_arg << "\n";
+        return 1;
+    }
+    GoalMap gmap(goal);
+    unique_ptr<DistanceTable> table;
+    if (db_path)
+    {
+        auto t0 = chrono::steady_clock::now();
+        table.reset(DistanceTable::open(db_path, gmap.canon));
+        if (!table)
+        {
+            DistanceTable(gmap.canon).save(db_path);
+            table.reset(DistanceTable::open(db_path, gmap.canon));
+        }
+        if (!table)
+        {
+            cerr << "无法建立距离表文件 " << db_path << "\n";
+            return 1;
+        }
+        cout << "距离表映射完成，用时=" << chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count()
+             << "us\n";
+    }
+    else if (use_table)
+    {
+        auto t0 = chrono::steady_clock::now();
+        table.reset(new DistanceTable(gmap.canon));
+        cout << "距离表建立完成，用时=" << chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count()
+             << "ms\n";
+    }
+
+    for (int i = 0; i < (int)states.size(); i++)
     {
         cout << "=============================\n";
         cout << "State" << (i + 1) << ":\n"
@@ -139,13 +223,61 @@ int main()
             cout << "该状态与目标奇偶性不同，不可达！\n";
             continue;
         }
-        vector<Board> path = bfs(states[i], goal);
-        if (path.empty())
+        if (table)
+        {
+            auto t0 = chrono::steady_clock::now();
+            vector<Board> path = gmap.path(*table, states[i]);
+            double us = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count();
+            if (path.empty())
+            {
+                cout << "未找到解\n";
+                continue;
+            }
+            string moves = path_moves(path);
+            cout << "查表找到解，步数=" << moves.size() << "，用时=" << us << "us\n";
+            cout << "移动: " << moves << "\n";
+            if (grid)
+                print_path(replay(states[i], moves));
+            continue;
+        }
+        if (frontier)
+        {
+            FrontierSearch<3, 3> search;
+            vector<Board> path = search.solve(states[i], goal);
+            if (path.empty())
+            {
+                cout << "未找到解\n";
+                continue;
+            }
+            string moves = path_moves(path);
+            cout << "前沿搜索找到解，步数=" << moves.size() << "，扩展节点数=" << search.expanded
+                 << "，最多同时保存状态数=" << search.peak << "\n";
+            cout << "移动: " << moves << "\n";
+            if (grid)
+                print_path(replay(states[i], moves));
+            continue;
+        }
+        long long expanded = 0;
+        string moves;
+        bool found;
+        if (bidirectional || threads >= 0)
+        {
+            vector<Board> path = bidirectional ? bibfs(states[i], goal, &expanded)
+                                               : parallel_bfs(states[i], goal, threads, &expanded);
+            found = !path.empty();
+            moves = path_moves(path);
+        }
+        else
+            found = bfs(states[i], goal, moves, &expanded);
+        if (!found)
             cout << "未找到解\n";
         else
         {
-            cout << "BFS 找到解，步数=" << (int)path.size() - 1 << "\n";
-            print_path(path);
+            cout << (bidirectional ? "双向BFS" : threads >= 0 ? "多线程BFS" : "BFS") << " 找到解，步数=" << moves.size()
+                 << "，扩展节点数=" << expanded << "\n";
+            cout << "移动: " << moves << "\n";
+            if (grid)
+                print_path(replay(states[i], moves));
         }
     }
 }
@@ -1,133 +1,94 @@
-#include <bits/stdc++.h>
-using namespace std;
+#include "puzzle.h"
 
-struct Board
-{
-    string s;
-    Board(string t = "1238_4765") : s(t) {}
-    int blank_pos() const { return (int)s.find('_'); }
-    bool operator==(const Board &o) const { return s == o.s; }
-    vector<Board> neighbors() const
-    {
-        static int dr[4] = {-1, 1, 0, 0}, dc[4] = {0, 0, -1, 1};
-        vector<Board> res;
-        int z = blank_pos(), r = z / 3, c = z % 3;
-        for (int k = 0; k < 4; k++)
-        {
-            int nr = r + dr[k], nc = c + dc[k];
-            if (nr < 0 || nr >= 3 || nc < 0 || nc >= 3)
-                continue;
-            int nz = nr * 3 + nc;
-            Board nb = *this;
-            swap(nb.s[z], nb.s[nz]);
-            res.push_back(nb);
-        }
-        return res;
-    }
-    string to_grid() const
-    {
-        string out;
-        for (int i = 0; i < 9; i++)
-        {
-            out.push_back(s[i]);
-            if (i % 3 != 2)
-                out.push_back(' ');
-            if (i % 3 == 2 && i != 8)
-                out.push_back('\n');
-        }
-        return out;
-    }
-};
-
-// 可达性判定
-int inversion_count(const string &x)
-{
-    vector<char> a;
-    for (char ch : x)
-        if (ch != '_')
-            a.push_back(ch);
-    int inv = 0;
-    for (int i = 0; i < (int)a.size(); i++)
-        for (int j = i + 1; j < (int)a.size(); j++)
-            if (a[i] > a[j])
-                inv++;
-    return inv;
-}
-bool solvable(const Board &s, const Board &g)
-{
-    return inversion_count(s.s) % 2 == inversion_count(g.s) % 2;
-}
-
-// 回溯路径
-vector<Board> reconstruct(const Board &goal, unordered_map<string, string> &parent)
-{
-    vector<Board> seq;
-    string cur = goal.s;
-    while (!cur.empty())
-    {
-        seq.push_back(Board(cur));
-        if (!parent.count(cur))
-            break;
-        cur = parent[cur];
-    }
-    reverse(seq.begin(), seq.end());
-    return seq;
-}
+#define DFS_MAX_DEPTH 64 // 显式栈的容量，深度限制不能超过此值
 
 // DFS (带深度限制)
-vector<Board> dfs(Board start, Board goal, int max_depth = 50)
+// 只有一个可变棋盘：前进时原地走一步，回溯时走回来；栈是定长数组，每层记录到达方向和待走的子方向，
+// 访问位图在搜索开始时一次分配，扩展节点不做任何堆分配。解就是栈上的方向序列，写成移动串放进 moves。
+// 子状态在压栈时标记访问、按字典序依次深入，与逐个压栈的迭代写法走出的路径完全相同。
+// max_depth 超过 DFS_MAX_DEPTH 时报错并返回false，不悄悄降低深度限制。
+bool dfs(Board start, Board goal, string &moves, int max_depth = 50)
 {
     struct Frame
     {
-        Board u;
-        int d;
+        int8_t kids[4]; // 按字典序排好的待走方向
+        int8_t n, next;
+        int8_t move; // 到达本层时空格移动的方向，根为-1
     };
-    vector<Frame> st;
-    unordered_set<string> vis;
-    unordered_map<string, string> parent;
-    st.push_back((Frame){start, 0});
-    vis.insert(start.s);
-    while (!st.empty())
+    if (max_depth > DFS_MAX_DEPTH)
     {
-        Frame fr = st.back();
-        st.pop_back();
-        Board u = fr.u;
-        int d = fr.d;
-        if (u == goal)
-            return reconstruct(u, parent);
-        if (d >= max_depth)
-            continue;
-        vector<Board> nb = u.neighbors();
-        sort(nb.begin(), nb.end(), [](const Board &a, const Board &b)
-             { return a.s < b.s; });
-        for (int i = (int)nb.size() - 1; i >= 0; i--)
+        cerr << "深度限制 " << max_depth << " 超过栈容量 DFS_MAX_DEPTH=" << DFS_MAX_DEPTH << "\n";
+        return false;
+    }
+    const auto &to = MOVES<3, 3>.to;
+    Frame st[DFS_MAX_DEPTH + 1];
+    VisitedBits vis; // 按排列编号的访问位
+    Board u = start;
+    vis.insert(board_rank(start));
+    st[0].move = -1;
+    int d = 0;
+    bool enter = true;
+    while (true)
+    {
+        Frame &f = st[d];
+        if (enter)
         {
-            Board v = nb[i];
-            if (!vis.count(v.s))
+            enter = false;
+            f.n = f.next = 0;
+            if (u == goal)
             {
-                vis.insert(v.s);
-                parent[v.s] = u.s;
-                st.push_back((Frame){v, d + 1});
+                moves.clear();
+                for (int i = 1; i <= d; i++)
+                    moves.push_back(MOVE_CHARS[st[i].move]);
+                return true;
+            }
+            if (d < max_depth)
+            {
+                // 空格z走到x得到的子状态之间的字典序只取决于 z 和 x：
+                // x 在 z 之后的按被移动的数字从小到大，排在前面；x 在 z 之前的按 x 从大到小排在后面
+                int key[4];
+                for (int k = 0; k < 4; k++)
+                {
+                    int x = to[u.z][k];
+                    if (x < 0 || k == (f.move ^ 1)) // 出界，或者直接走回父状态
+                        continue;
+                    if (!vis.insert(board_rank(u.moved(x))))
+                        continue;
+                    int e = x > u.z ? u.tile(x) : 32 - x, j = f.n++;
+                    for (; j > 0 && key[j - 1] > e; j--)
+                    {
+                        key[j] = key[j - 1];
+                        f.kids[j] = f.kids[j - 1];
+                    }
+                    key[j] = e;
+                    f.kids[j] = (int8_t)k;
+                }
             }
         }
-    }
-    return vector<Board>();
-}
-
-// 打印路径
-void print_path(const vector<Board> &path)
-{
-    for (int i = 0; i < (int)path.size(); i++)
-    {
-        cout << "Step " << i << ":\n"
-             << path[i].to_grid() << "\n\n";
+        if (f.next < f.n)
+        {
+            int k = f.kids[f.next++];
+            u.apply(to[u.z][k]);
+            st[++d].move = (int8_t)k;
+            enter = true;
+        }
+        else if (d == 0)
+            return false;
+        else
+        {
+            u.apply(to[u.z][st[d].move ^ 1]);
+            d--;
+        }
     }
 }
 
-int main()
+// 用法: 8-PuzzleProblem_DFS [-grid]
+// 解输出为空格的移动串（U上 D下 L左 R右），-grid 时再重放并打印每一步的棋盘
+int main(int argc, char *argv[])
 {
     system("chcp 65001 > nul");
     
+    bool grid = argc > 1 && strcmp(argv[1], "-grid") == 0;
     Board goal("1238_4765"); // 新目标状态
 
     // 6个初始状态
@@ -150,13 +111,15 @@ int main()
             cout << "该状态与目标奇偶性不同，不可达！\n";
             continue;
         }
-        vector<Board> path = dfs(states[i], goal, 50); // 深度限制50
-        if (path.empty())
+        string moves;
+        if (!dfs(states[i], goal, moves, 50)) // 深度限制50
             cout << "未找到解(可能深度不够)\n";
         else
         {
-            cout << "DFS 找到解，步数=" << (int)path.size() - 1 << "\n";
-            print_path(path);
+            cout << "DFS 找到解，步数=" << moves.size() << "\n";
+            cout << "移动: " << moves << "\n";
+            if (grid)
+                print_path(replay(states[i], moves));
         }
     }
 }
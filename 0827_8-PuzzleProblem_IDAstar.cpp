@@ -0,0 +1,56 @@
+#include "puzzle.h"
+
+// 用法: 8-PuzzleProblem_IDAstar [-grid] [初始状态...]，不给初始状态时求解默认的6个状态
+// 解输出为空格的移动串（U上 D下 L左 R右），-grid 时再重放并打印每一步的棋盘
+int main(int argc, char *argv[])
+{
+    system("chcp 65001 > nul");
+
+    Board goal("1238_4765"); // 目标状态
+
+    // 6个初始状态
+    vector<Board> states = {
+        Board("2831647_5"), // State1
+        Board("2831_4765"), // State2
+        Board("2_3184765"), // State3
+        Board("_12345678"), // State4
+        Board("1234_6758"), // State5
+        Board("152_34678")  // State6
+    };
+    bool grid = false;
+    vector<Board> queries;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-grid") == 0)
+            grid = true;
+        else
+        {
+            queries.push_back(Board(argv[i]));
+            if (!queries.back().valid())
+            {
+                cerr << "初始状态不合法: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+    }
+    if (!queries.empty())
+        states = queries;
+
+    for (int i = 0; i < (int)states.size(); i++)
+    {
+        cout << "=============================\n";
+        cout << "State" << (i + 1) << ":\n"
+             << states[i].to_grid() << "\n\n";
+        if (!solvable(states[i], goal))
+        {
+            cout << "该状态与目标奇偶性不同，不可达！\n";
+            continue;
+        }
+        IdaStar solver(goal);
+        string moves = path_moves(solver.solve(states[i]));
+        cout << "IDA* 找到解，步数=" << moves.size() << "，扩展节点数=" << solver.expanded << "\n";
+        cout << "移动: " << moves << "\n";
+        if (grid)
+            print_path(replay(states[i], moves));
+    }
+}
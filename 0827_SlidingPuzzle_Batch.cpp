@@ -0,0 +1,278 @@
+#include "puzzle.h"
+
+// 滑块拼图实例生成与批量求解：多线程逐个求解，每个实例输出一行结果并统计吞吐量
+// 用法: SlidingPuzzle_Batch [-size 4x4] [-goal "..."] [-in file | -random n [-depth d] [-seed s]] [-gen]
+//                           [-algo ida|pdb|frontier|table|bfs] [-pdb prefix] [-t threads] [-o file]
+// -in     从文件读入实例，每行一个（格式同命令行的初始状态），空行和 # 开头的行忽略，不合法的行报告后跳过
+// -random 生成n个随机可解实例；给 -depth 时每个实例的最优步数恰为d，否则为均匀随机打乱
+// -gen    只输出生成的实例（每行一个），不求解
+// -algo   求解方法：ida 曼哈顿+线性冲突的IDA*（默认），pdb 加性模式数据库的IDA*，
+//         frontier 前沿搜索（不支持5x5），table 八数码距离表查询，bfs 八数码逐层BFS（后两种只支持3x3）
+// -pdb    模式数据库文件前缀，默认 pdb
+// -t      线程数，0表示使用全部核心（默认）
+// -o      结果写入文件，默认输出到屏幕
+// 结果每行以制表符分隔：初始状态、移动串（U上 D下 L左 R右，不可解为 -）、步数（不可解为-1）、扩展节点数、用时(us)
+
+struct Options
+{
+    string goal, in, out, algo = "ida", pdb = "pdb";
+    int random = 0, depth = -1, threads = 0;
+    unsigned seed = 1;
+    bool gen = false;
+};
+
+struct Result
+{
+    string moves;
+    int length = -1;
+    long long nodes = 0;
+    double us = 0;
+};
+
+// 每个线程取下一个未求解的实例，solve(start, result) 必须可以并发调用
+template <class B, class F>
+void solve_batch(const vector<B> &starts, vector<Result> &res, int threads, F solve)
+{
+    atomic<size_t> next(0);
+    auto work = [&]()
+    {
+        for (size_t i; (i = next.fetch_add(1)) < starts.size();)
+        {
+            auto t0 = chrono::steady_clock::now();
+            solve(starts[i], res[i]);
+            res[i].us = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count();
+        }
+    };
+    vector<thread> pool;
+    for (int t = 1; t < threads; t++)
+        pool.emplace_back(work);
+    work();
+    for (thread &th : pool)
+        th.join();
+}
+
+template <int R, int C>
+int run(const Options &opt)
+{
+    typedef BoardT<R, C> B;
+    B goal = opt.goal.empty() ? B() : B(opt.goal);
+    if (!goal.valid())
+    {
+        cerr << "目标状态不合法: " << opt.goal << "\n";
+        return 1;
+    }
+    const bool small = R == 3 && C == 3;
+    if ((opt.algo == "table" || opt.algo == "bfs") && !small)
+    {
+        cerr << "-algo " << opt.algo << " 只支持3x3\n";
+        return 1;
+    }
+    if (opt.algo == "frontier" && R * C > 16)
+    {
+        cerr << "-algo frontier 只支持16格以内的棋盘\n";
+        return 1;
+    }
+    if (opt.algo != "ida" && opt.algo != "pdb" && opt.algo != "frontier" && opt.algo != "table" && opt.algo != "bfs")
+    {
+        cerr << "未知的求解方法: " << opt.algo << "\n";
+        return 1;
+    }
+
+    // 读入或生成实例
+    HeuristicT<R, C> heur(goal);
+    vector<B> starts;
+    if (!opt.in.empty())
+    {
+        ifstream in(opt.in);
+        if (!in)
+        {
+            cerr << "无法读取 " << opt.in << "\n";
+            return 1;
+        }
+        int lineno = 0, skipped = 0;
+        for (string line; getline(in, line);)
+        {
+            lineno++;
+            if (line.empty() || line[0] == '#' || line[0] == '\r')
+                continue;
+            if (line.back() == '\r')
+                line.pop_back();
+            B b(line);
+            if (!b.valid())
+            {
+                cerr << opt.in << ":" << lineno << ": 实例不合法，已跳过: " << line << "\n";
+                skipped++;
+                continue;
+            }
+            starts.push_back(b);
+        }
+        if (skipped)
+            cerr << "共跳过 " << skipped << " 个不合法的实例\n";
+    }
+    mt19937 rng(opt.seed);
+    for (int i = 0; i < opt.random; i++)
+    {
+        B b;
+        if (opt.depth < 0)
+            b = random_board(goal, rng);
+        else if (!random_board_at(goal, opt.depth, rng, heur, b))
+        {
+            cerr << "无法生成最优步数为 " << opt.depth << " 的实例\n";
+            return 1;
+        }
+        starts.push_back(b);
+    }
+
+    FILE *fp = opt.out.empty() ? stdout : fopen(opt.out.c_str(), "w");
+    if (!fp)
+    {
+        cerr << "无法写入 " << opt.out << "\n";
+        return 1;
+    }
+    if (opt.gen)
+    {
+        for (const B &b : starts)
+            fprintf(fp, "%s\n", b.str().c_str());
+        if (fp != stdout)
+            fclose(fp);
+        return 0;
+    }
+
+    int threads = opt.threads > 0 ? opt.threads : max(1u, thread::hardware_concurrency());
+    vector<Result> res(starts.size());
+    // 吞吐量只算求解：建表、加载和校验数据库的时间单独记为准备用时，t0 在准备完成后重设
+    auto setup0 = chrono::steady_clock::now(), t0 = setup0;
+    if (opt.algo == "ida")
+        solve_batch(starts, res, threads, [&](const B &s, Result &r)
+                    {
+            IdaStarT<R, C> solver(goal, heur);
+            vector<B> path = solver.solve(s);
+            r.nodes = solver.expanded;
+            if (!path.empty())
+                r.moves = path_moves(path), r.length = (int)r.moves.size(); });
+    else if (opt.algo == "pdb")
+    {
+        // 写不进文件的数据库下次还要重新生成，批量任务里按错误处理，不带着它继续
+        AdditivePDB<R, C> pdb(goal);
+        if (!pdb.prepare(opt.pdb))
+        {
+            cerr << "模式数据库写入失败: " << opt.pdb << "\n";
+            if (fp != stdout)
+                fclose(fp);
+            return 1;
+        }
+        t0 = chrono::steady_clock::now();
+        solve_batch(starts, res, threads, [&](const B &s, Result &r)
+                    {
+            IdaStarT<R, C, AdditivePDB<R, C>> solver(goal, pdb);
+            vector<B> path = solver.solve(s);
+            r.nodes = solver.expanded;
+            if (!path.empty())
+                r.moves = path_moves(path), r.length = (int)r.moves.size(); });
+    }
+    else if (opt.algo == "frontier")
+    {
+        if constexpr (R * C <= 16)
+            solve_batch(starts, res, threads, [&](const B &s, Result &r)
+                        {
+                if (!solvable(s, goal))
+                    return;
+                FrontierSearch<R, C> search;
+                vector<B> path = search.solve(s, goal);
+                r.nodes = search.expanded;
+                if (!path.empty())
+                    r.moves = path_moves(path), r.length = (int)r.moves.size(); });
+    }
+    else if constexpr (R == 3 && C == 3)
+    {
+        if (opt.algo == "table")
+        {
+            GoalMap gmap(goal);
+            DistanceTable table(gmap.canon);
+            t0 = chrono::steady_clock::now();
+            solve_batch(starts, res, threads, [&](const B &s, Result &r)
+                        {
+                if (!solvable(s, goal))
+                    return;
+                r.moves = path_moves(gmap.path(table, s));
+                r.length = (int)r.moves.size();
+                r.nodes = r.length; });
+        }
+        else
+        {
+            PartialSpace<3, 3> space({1, 2, 3, 4, 5, 6, 7, 8}, goal);
+            solve_batch(starts, res, threads, [&](const B &s, Result &r)
+                        {
+                if (!solvable(s, goal))
+                    return;
+                ParallelBfs<PartialSpace<3, 3>> search(space, 1);
+                uint32_t rg = space.rank(goal);
+                r.nodes = (long long)search.run(space.rank(s), -1, rg);
+                vector<B> path;
+                for (uint32_t x : search.path(rg))
+                    path.push_back(space.board(x));
+                r.moves = path_moves(path);
+                r.length = (int)r.moves.size(); });
+        }
+    }
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    double setup = chrono::duration<double>(t0 - setup0).count();
+
+    long long nodes = 0;
+    int solved = 0;
+    for (size_t i = 0; i < starts.size(); i++)
+    {
+        fprintf(fp, "%s\t%s\t%d\t%lld\t%.0f\n", starts[i].str().c_str(), res[i].length < 0 ? "-" : res[i].moves.c_str(),
+                res[i].length, res[i].nodes, res[i].us);
+        nodes += res[i].nodes;
+        solved += res[i].length >= 0;
+    }
+    if (fp != stdout)
+        fclose(fp);
+    double s = sec > 0 ? sec : 1e-9;
+    cout << "# " << starts.size() << " 个实例，解出 " << solved << " 个，线程数=" << threads << "，准备用时=" << setup
+         << "s，求解用时=" << sec << "s，" << starts.size() / s << " 实例/秒，" << (long long)(nodes / s) << " 节点/秒\n";
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    system("chcp 65001 > nul");
+
+    Options opt;
+    string size = "4x4";
+    for (int i = 1; i < argc; i++)
+    {
+        string a = argv[i];
+        if (a == "-size" && i + 1 < argc)
+            size = argv[++i];
+        else if (a == "-goal" && i + 1 < argc)
+            opt.goal = argv[++i];
+        else if (a == "-in" && i + 1 < argc)
+            opt.in = argv[++i];
+        else if (a == "-random" && i + 1 < argc)
+            opt.random = atoi(argv[++i]);
+        else if (a == "-depth" && i + 1 < argc)
+            opt.depth = atoi(argv[++i]);
+        else if (a == "-seed" && i + 1 < argc)
+            opt.seed = (unsigned)atoi(argv[++i]);
+        else if (a == "-gen")
+            opt.gen = true;
+        else if (a == "-algo" && i + 1 < argc)
+            opt.algo = argv[++i];
+        else if (a == "-pdb" && i + 1 < argc)
+            opt.pdb = argv[++i];
+        else if (a == "-t" && i + 1 < argc)
+            opt.threads = atoi(argv[++i]);
+        else if (a == "-o" && i + 1 < argc)
+            opt.out = argv[++i];
+    }
+    if (size == "3x3")
+        return run<3, 3>(opt);
+    if (size == "4x4")
+        return run<4, 4>(opt);
+    if (size == "5x5")
+        return run<5, 5>(opt);
+    cerr << "不支持的尺寸: " << size << "\n";
+    return 1;
+}
@@ -0,0 +1,107 @@
+#include "puzzle.h"
+
+// 外存BFS：逐层写有序文件、延迟重复检测，统计 R×C 滑块拼图每个深度的状态数
+// 用法: SlidingPuzzle_ExternalBFS [-size 4x4] [-goal "..."] [-mem MB] [-dir prefix] [-depth d] [-hard file [count]]
+// -size   棋盘尺寸：2x3、2x4、3x3、3x4、4x4，默认4x4
+// -goal   目标状态，默认为 1..N-1 后接空格（3x3 为 "1238_4765"）
+// -mem    扩展缓冲区的内存上限(MB)，默认256
+// -dir    层文件和run文件的路径前缀，默认 ebfs；需要能放下相邻三层的磁盘空间（每状态8字节）
+// -depth  只扩展到该深度
+// -hard   把最后一层（离目标最远）的状态写入文件，每行一个，最多count个（默认全部）
+
+struct Options
+{
+    string goal, prefix = "ebfs", hard;
+    size_t mem_mb = 256;
+    int depth = -1;
+    uint64_t hard_count = UINT64_MAX;
+};
+
+template <int R, int C>
+int run(const Options &opt)
+{
+    typedef BoardT<R, C> B;
+    B goal = opt.goal.empty() ? B() : B(opt.goal);
+    if (!goal.valid())
+    {
+        cerr << "目标状态不合法: " << (opt.goal.empty() ? B::default_goal() : opt.goal) << "\n";
+        return 1;
+    }
+    ExternalBfs<R, C> search(opt.prefix, opt.mem_mb << 20);
+
+    auto t0 = chrono::steady_clock::now();
+    int last = search.run(goal, opt.depth);
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    if (last < 0)
+    {
+        cerr << "读写 " << opt.prefix << ".* 失败\n";
+        return 1;
+    }
+
+    uint64_t total = 0;
+    for (int d = 0; d < (int)search.layers.size(); d++)
+    {
+        cout << "深度 " << d << ": " << search.layers[d] << "\n";
+        total += search.layers[d];
+    }
+    cout << "共 " << total << " 个状态，用时=" << sec << "s\n";
+
+    if (!opt.hard.empty())
+    {
+        FILE *fp = fopen(opt.hard.c_str(), "w");
+        if (!fp)
+        {
+            cerr << "无法写入 " << opt.hard << "\n";
+            return 1;
+        }
+        uint64_t n = 0;
+        search.each(last, [&](const B &b)
+                    {
+            if (n++ < opt.hard_count)
+                fprintf(fp, "%s\n", b.str().c_str()); });
+        fclose(fp);
+        cout << "深度 " << last << " 的 " << min(n, opt.hard_count) << " 个状态已写入 " << opt.hard << "\n";
+    }
+    remove(search.level_path(last).c_str());
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    system("chcp 65001 > nul");
+
+    Options opt;
+    string size = "4x4";
+    for (int i = 1; i < argc; i++)
+    {
+        string a = argv[i];
+        if (a == "-size" && i + 1 < argc)
+            size = argv[++i];
+        else if (a == "-goal" && i + 1 < argc)
+            opt.goal = argv[++i];
+        else if (a == "-mem" && i + 1 < argc)
+            opt.mem_mb = strtoull(argv[++i], NULL, 10);
+        else if (a == "-dir" && i + 1 < argc)
+            opt.prefix = argv[++i];
+        else if (a == "-depth" && i + 1 < argc)
+            opt.depth = atoi(argv[++i]);
+        else if (a == "-hard" && i + 1 < argc)
+        {
+            opt.hard = argv[++i];
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0]))
+                opt.hard_count = strtoull(argv[++i], NULL, 10);
+        }
+    }
+    if (size == "2x3")
+        return run<2, 3>(opt);
+    if (size == "2x4")
+        return run<2, 4>(opt);
+    if (size == "3x3")
+        return run<3, 3>(opt);
+    if (size == "3x4")
+        return run<3, 4>(opt);
+    if (size == "4x4")
+        return run<4, 4>(opt);
+    cerr << "不支持的尺寸: " << size << "\n";
+    return 1;
+}
@@ -0,0 +1,131 @@
+#include "puzzle.h"
+
+// R×C 滑块拼图的 IDA* 求解（3×3、4×4、5×5）
+// 用法: SlidingPuzzle_IDAstar [-size 4x4] [-goal "..."] [-pdb prefix] [-gen] [-random n [seed]] [-path] [初始状态...]
+// -size   棋盘尺寸，默认4x4
+// -goal   目标状态，默认为 1..N-1 后接空格（3x3 为 "1238_4765"）
+// -pdb    使用加性模式数据库，从 prefix.RxC.i.pdb 读取，文件不存在时先生成；不给时用曼哈顿+线性冲突
+// -gen    只生成模式数据库文件（需要 -pdb）
+// -random 生成n个随机可解状态
+// -path   除移动串（U上 D下 L左 R右）外，打印每一步的棋盘
+// 初始状态：9格以内写作 "2831647_5"，更大的棋盘写作空格分隔的数字（需加引号），0或_为空格
+
+struct Options
+{
+    string goal, pdb;
+    bool gen = false, path = false;
+    int random = 0;
+    unsigned seed = 1;
+    vector<string> starts;
+};
+
+template <int R, int C, class H>
+void solve_all(const vector<BoardT<R, C>> &starts, const BoardT<R, C> &goal, const H *heur, bool show_path)
+{
+    for (int i = 0; i < (int)starts.size(); i++)
+    {
+        cout << "=============================\n";
+        cout << "State" << (i + 1) << ":\n"
+             << starts[i].to_grid() << "\n\n";
+        if (!solvable(starts[i], goal))
+        {
+            cout << "该状态与目标奇偶性不同，不可达！\n";
+            continue;
+        }
+        IdaStarT<R, C, H> solver = heur ? IdaStarT<R, C, H>(goal, *heur) : IdaStarT<R, C, H>(goal);
+        auto t0 = chrono::steady_clock::now();
+        vector<BoardT<R, C>> path = solver.solve(starts[i]);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        cout << "IDA* 找到解，步数=" << (int)path.size() - 1 << "，扩展节点数=" << solver.expanded
+             << "，用时=" << ms << "ms\n";
+        cout << "移动: " << path_moves(path) << "\n";
+        if (show_path)
+            print_path(path);
+    }
+}
+
+template <int R, int C>
+int run(const Options &opt)
+{
+    typedef BoardT<R, C> B;
+    B goal = opt.goal.empty() ? B() : B(opt.goal);
+    if (!goal.valid())
+    {
+        cerr << "目标状态不合法: " << (opt.goal.empty() ? B::default_goal() : opt.goal) << "\n";
+        return 1;
+    }
+
+    if (opt.gen && opt.pdb.empty())
+    {
+        cerr << "-gen 需要 -pdb prefix\n";
+        return 1;
+    }
+    vector<B> starts;
+    for (const string &s : opt.starts)
+    {
+        starts.push_back(B(s));
+        if (!starts.back().valid())
+        {
+            cerr << "初始状态不合法: " << s << "\n";
+            return 1;
+        }
+    }
+    mt19937 rng(opt.seed);
+    for (int i = 0; i < opt.random; i++)
+        starts.push_back(random_board(goal, rng));
+
+    if (!opt.pdb.empty())
+    {
+        AdditivePDB<R, C> pdb(goal);
+        auto t0 = chrono::steady_clock::now();
+        if (!pdb.prepare(opt.pdb))
+        {
+            cerr << "模式数据库写入失败: " << opt.pdb << "\n";
+            return 1;
+        }
+        cout << "模式数据库就绪，用时=" << chrono::duration<double>(chrono::steady_clock::now() - t0).count() << "s\n";
+        if (!opt.gen)
+            solve_all<R, C>(starts, goal, &pdb, opt.path);
+    }
+    else
+        solve_all<R, C, HeuristicT<R, C>>(starts, goal, NULL, opt.path);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    system("chcp 65001 > nul");
+
+    Options opt;
+    string size = "4x4";
+    for (int i = 1; i < argc; i++)
+    {
+        string a = argv[i];
+        if (a == "-size" && i + 1 < argc)
+            size = argv[++i];
+        else if (a == "-goal" && i + 1 < argc)
+            opt.goal = argv[++i];
+        else if (a == "-pdb" && i + 1 < argc)
+            opt.pdb = argv[++i];
+        else if (a == "-gen")
+            opt.gen = true;
+        else if (a == "-path")
+            opt.path = true;
+        else if (a == "-random" && i + 1 < argc)
+        {
+            opt.random = atoi(argv[++i]);
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0]))
+                opt.seed = (unsigned)atoi(argv[++i]);
+        }
+        else
+            opt.starts.push_back(a);
+    }
+    if (size == "3x3")
+        return run<3, 3>(opt);
+    if (size == "4x4")
+        return run<4, 4>(opt);
+    if (size == "5x5")
+        return run<5, 5>(opt);
+    cerr << "不支持的尺寸: " << size << "\n";
+    return 1;
+}
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <vector>
+#include "sudoku.h"
 using namespace std;
 
 // 全局常量：数独尺寸（9×9）
@@ -7,51 +8,6 @@ const int SIZE = 9;
 // 3×3宫的尺寸
 const int SUB_SIZE = 3;
 
-/**
- * @brief 校验数字填入合法性
- * @param board 数独盘面
- * @param row 目标行坐标
- * @param col 目标列坐标
- * @param num 待填入数字（1-9）
- * @return 合法返回true，否则返回false
- */
-bool isValid(const vector<vector<int>> &board, int row, int col, int num)
-{
-    // 1. 校验当前行：是否已存在num
-    for (int c = 0; c < SIZE; ++c)
-    {
-        if (board[row][c] == num)
-        {
-            return false;
-        }
-    }
-
-    // 2. 校验当前列：是否已存在num
-    for (int r = 0; r < SIZE; ++r)
-    {
-        if (board[r][col] == num)
-        {
-            return false;
-        }
-    }
-
-    // 3. 校验当前3×3宫：计算宫的起始坐标
-    int startRow = (row / SUB_SIZE) * SUB_SIZE;
-    int startCol = (col / SUB_SIZE) * SUB_SIZE;
-    for (int i = startRow; i < startRow + SUB_SIZE; ++i)
-    {
-        for (int j = startCol; j < startCol + SUB_SIZE; ++j)
-        {
-            if (board[i][j] == num)
-            {
-                return false;
-            }
-        }
-    }
-
-    return true; // 三重校验通过，数字合法
-}
-
 /**
  * @brief 寻找下一个空格（行优先：从上到下、从左到右）
  * @param board 数独盘面
@@ -77,9 +33,10 @@ bool findEmpty(const vector<vector<int>> &board, int &row, int &col)
 /**
  * @brief DFS回溯求解数独（核心函数）
  * @param board 数独盘面（引用传递，直接修改）
+ * @param mask 与盘面一致的行/列/宫掩码，随填数、回溯同步更新
  * @return 找到解返回true，无解返回false
  */
-bool dfsSolve(vector<vector<int>> &board)
+bool dfsSolve(vector<vector<int>> &board, SudokuMask &mask)
 {
     int row, col;
     // 终止条件：无空格 → 解成功
@@ -88,26 +45,25 @@ bool dfsSolve(vector<vector<int>> &board)
         return true;
     }
 
-    // 尝试填入1-9的每个数字
-    for (int num = 1; num <= SIZE; ++num)
+    // 按从小到大的顺序尝试该格的每个候选数字（候选已经排除了行、列、宫中出现过的数字）
+    for (uint16_t cand = mask.candidates(row, col); cand; cand &= cand - 1)
     {
-        // 校验数字合法性
-        if (isValid(board, row, col, num))
-        {
-            board[row][col] = num; // 填入合法数字
+        int num = sudoku_digit(cand);
+        board[row][col] = num; // 填入合法数字
+        mask.place(row, col, num);
 
-            // 递归求解：若后续路径找到解，直接返回true（终止递归）
-            if (dfsSolve(board))
-            {
-                return true;
-            }
-
-            // 回溯：当前数字无效，恢复为空格（0），尝试下一个数字
-            board[row][col] = 0;
+        // 递归求解：若后续路径找到解，直接返回true（终止递归）
+        if (dfsSolve(board, mask))
+        {
+            return true;
         }
+
+        // 回溯：当前数字无效，恢复为空格（0），尝试下一个数字
+        board[row][col] = 0;
+        mask.remove(row, col, num);
     }
 
-    // 1-9均无效，返回false，通知上层递归更换数字
+    // 候选均无效，返回false，通知上层递归更换数字
     return false;
 }
 
@@ -194,7 +150,8 @@ int main()
     cout << endl; // 空行分隔初始状态与结果
 
     // 调用DFS求解
-    if (dfsSolve(currentTest))
+    SudokuMask mask;
+    if (mask.init(currentTest) && dfsSolve(currentTest, mask))
     {
         cout << "求解结果：" << endl;
         printBoard(currentTest);
@@ -1,48 +1,13 @@
 #include <iostream>
 #include <vector>
 #include <queue>
+#include "sudoku.h"
 using namespace std;
 
 // 数独尺寸常量
 const int SIZE = 9;
 const int SUB_SIZE = 3;
 
-/**
- * @brief 校验数字填入合法性（与 DFS 版本一致）
- * @param board 数独状态
- * @param row 目标行
- * @param col 目标列
- * @param num 待填数字
- * @return 合法返回 true，否则 false
- */
-bool isValid(const vector<vector<int>> &board, int row, int col, int num)
-{
-    // 校验行
-    for (int c = 0; c < SIZE; ++c)
-    {
-        if (board[row][c] == num)
-            return false;
-    }
-    // 校验列
-    for (int r = 0; r < SIZE; ++r)
-    {
-        if (board[r][col] == num)
-            return false;
-    }
-    // 校验 3×3 宫
-    int startRow = (row / SUB_SIZE) * SUB_SIZE;
-    int startCol = (col / SUB_SIZE) * SUB_SIZE;
-    for (int i = startRow; i < startRow + SUB_SIZE; ++i)
-    {
-        for (int j = startCol; j < startCol + SUB_SIZE; ++j)
-        {
-            if (board[i][j] == num)
-                return false;
-        }
-    }
-    return true;
-}
-
 /**
  * @brief 寻找下一个待填空格（行优先，与 DFS 版本一致）
  * @param board 数独状态
@@ -81,6 +46,15 @@ void printBoard(const vector<vector<int>> &board)
     }
 }
 
+// 队列元素：数独状态、与之一致的行/列/宫掩码、下一个待填空格的坐标
+// 记录空格坐标避免每次出队后重复调用 findEmpty 找空格
+struct BfsNode
+{
+    vector<vector<int>> board;
+    SudokuMask mask;
+    int row, col;
+};
+
 /**
  * @brief BFS 求解数独（核心函数）
  * @param initialBoard 初始数独状态
@@ -89,15 +63,18 @@ void printBoard(const vector<vector<int>> &board)
  */
 bool bfsSolve(const vector<vector<int>> &initialBoard, vector<vector<int>> &result)
 {
-    // 队列元素：pair<当前数独状态, 下一个待填空格的坐标>
-    // 用 pair 存储 (row, col)，避免每次出队后重复调用 findEmpty 找空格
-    queue<pair<vector<vector<int>>, pair<int, int>>> q;
+    queue<BfsNode> q;
 
-    // 1. 初始化队列：计算初始状态的第一个空格，入队
-    int initRow, initCol;
-    if (findEmpty(initialBoard, initRow, initCol))
+    // 1. 初始化队列：建立掩码，计算初始状态的第一个空格，入队
+    BfsNode start;
+    start.board = initialBoard;
+    if (!start.mask.init(initialBoard))
     {
-        q.push({initialBoard, {initRow, initCol}});
+        return false; // 题面本身有重复数字
+    }
+    if (findEmpty(initialBoard, start.row, start.col))
+    {
+        q.push(start);
     }
     else
     {
@@ -110,33 +87,30 @@ bool bfsSolve(const vector<vector<int>> &initialBoard, vector<vector<int>> &resu
     while (!q.empty())
     {
         // 出队：获取当前状态和下一个待填空格
-        auto current = q.front();
+        BfsNode current = move(q.front());
         q.pop();
-        vector<vector<int>> currentBoard = current.first;
-        int row = current.second.first;
-        int col = current.second.second;
+        int row = current.row;
+        int col = current.col;
 
-        // 3. 尝试为当前空格填入 1-9 的合法数字
-        for (int num = 1; num <= SIZE; ++num)
+        // 3. 按从小到大的顺序为当前空格填入每个候选数字
+        for (uint16_t cand = current.mask.candidates(row, col); cand; cand &= cand - 1)
         {
-            if (isValid(currentBoard, row, col, num))
+            int num = sudoku_digit(cand);
+            // 生成新状态（复制当前状态，填入合法数字）
+            BfsNode next = current;
+            next.board[row][col] = num;
+            next.mask.place(row, col, num);
+
+            // 4. 检查新状态是否为终态（无空格）
+            if (!findEmpty(next.board, next.row, next.col))
             {
-                // 生成新状态（复制当前状态，填入合法数字）
-                vector<vector<int>> newBoard = currentBoard;
-                newBoard[row][col] = num;
-
-                // 4. 检查新状态是否为终态（无空格）
-                int nextRow, nextCol;
-                if (!findEmpty(newBoard, nextRow, nextCol))
-                {
-                    // 找到终态，赋值给 result 并返回
-                    result = newBoard;
-                    return true;
-                }
-
-                // 5. 新状态不是终态，入队（记录下一个待填空格）
-                q.push({newBoard, {nextRow, nextCol}});
+                // 找到终态，赋值给 result 并返回
+                result = next.board;
+                return true;
             }
+
+            // 5. 新状态不是终态，入队（记录下一个待填空格）
+            q.push(move(next));
         }
     }
 
@@ -144,7 +118,6 @@ bool bfsSolve(const vector<vector<int>> &initialBoard, vector<vector<int>> &resu
     return false;
 }
 
-
 // 文档其他初始状态（可替换测试）
 vector<vector<int>> sampleInput = {
     {8, 0, 0, 0, 0, 0, 0, 0, 0},
@@ -1,45 +1,12 @@
 #include <iostream>
 #include <vector>
 #include <stack>
+#include "sudoku.h"
 using namespace std;
 
 const int SIZE = 9;
 const int SUB_SIZE = 3;
 
-/**
- * @brief 校验数字填入合法性
- */
-bool isValid(const vector<vector<int>> &board, int row, int col, int num)
-{
-    // 检查行
-    for (int c = 0; c < SIZE; ++c)
-    {
-        if (board[row][c] == num)
-            return false;
-    }
-
-    // 检查列
-    for (int r = 0; r < SIZE; ++r)
-    {
-        if (board[r][col] == num)
-            return false;
-    }
-
-    // 检查3×3宫
-    int startRow = (row / SUB_SIZE) * SUB_SIZE;
-    int startCol = (col / SUB_SIZE) * SUB_SIZE;
-    for (int i = startRow; i < startRow + SUB_SIZE; ++i)
-    {
-        for (int j = startCol; j < startCol + SUB_SIZE; ++j)
-        {
-            if (board[i][j] == num)
-                return false;
-        }
-    }
-
-    return true;
-}
-
 /**
  * @brief 寻找下一个空格（从指定位置开始）
  */
@@ -63,9 +30,14 @@ bool findNextEmpty(const vector<vector<int>> &board, int &row, int &col)
 
 /**
  * @brief 使用栈实现的DFS求解数独（非递归）
+ * 行/列/宫掩码与盘面同步更新，下一个要试的数字直接从候选掩码中取
  */
 bool stackSolve(vector<vector<int>> &board)
 {
+    SudokuMask mask;
+    if (!mask.init(board))
+        return false; // 题面本身有重复数字
+
     stack<pair<int, int>> posStack; // 存储位置 (row, col)
     stack<int> numStack;            // 存储当前尝试的数字
 
@@ -103,42 +75,38 @@ bool stackSolve(vector<vector<int>> &board)
         if (board[currentRow][currentCol] != 0 && currentNum > 0)
         {
             board[currentRow][currentCol] = 0;
+            mask.remove(currentRow, currentCol, currentNum);
         }
 
-        // 尝试下一个数字
-        currentNum++;
+        // 下一个要试的数字：比 currentNum 大的最小候选
+        uint16_t rest = mask.candidates(currentRow, currentCol) & (SUDOKU_ALL << currentNum);
 
         // 如果所有数字都尝试过了，回溯
-        if (currentNum > SIZE)
+        if (!rest)
         {
             posStack.pop();
             numStack.pop();
-            if (!posStack.empty())
-            {
-                board[currentRow][currentCol] = 0; // 清除当前数字
-            }
             continue;
         }
 
-        // 检查当前数字是否合法
-        if (isValid(board, currentRow, currentCol, currentNum))
-        {
-            board[currentRow][currentCol] = currentNum;
+        // 候选已排除行、列、宫中出现过的数字，直接填入
+        currentNum = sudoku_digit(rest);
+        board[currentRow][currentCol] = currentNum;
+        mask.place(currentRow, currentCol, currentNum);
 
-            // 寻找下一个空格
-            int nextRow = currentRow;
-            int nextCol = currentCol;
-            if (findNextEmpty(board, nextRow, nextCol))
-            {
-                // 还有空格，继续处理
-                posStack.push({nextRow, nextCol});
-                numStack.push(0);
-            }
-            else
-            {
-                // 没有空格了，求解完成
-                return true;
-            }
+        // 寻找下一个空格
+        int nextRow = currentRow;
+        int nextCol = currentCol;
+        if (findNextEmpty(board, nextRow, nextCol))
+        {
+            // 还有空格，继续处理
+            posStack.push({nextRow, nextCol});
+            numStack.push(0);
+        }
+        else
+        {
+            // 没有空格了，求解完成
+            return true;
         }
     }
 
@@ -3,6 +3,7 @@
 #include <algorithm> 
 #include <random>    // 随机数引擎与分布
 #include <chrono>    // 计时与随机种子
+#include "sudoku.h"  // 行/列/宫掩码
 using namespace std; 
 
 const int SIZE = 9;     
@@ -23,32 +24,6 @@ void printBoard(const vector<vector<int>> &board)
     }
 }
 
-// 合法性检查（行/列/宫不能重复）——用于初始化或必要时校验
-bool isValid(const vector<vector<int>> &board, int row, int col, int num)
-{
-    for (int c = 0; c < SIZE; ++c)
-    { // 检查所在行
-        if (board[row][c] == num)
-            return false; // 同行已出现 num
-    }
-    for (int r = 0; r < SIZE; ++r)
-    { // 检查所在列
-        if (board[r][col] == num)
-            return false; // 同列已出现 num
-    }
-    int sr = (row / SUB_SIZE) * SUB_SIZE; // 子宫起始行
-    int sc = (col / SUB_SIZE) * SUB_SIZE; // 子宫起始列
-    for (int i = sr; i < sr + SUB_SIZE; ++i)
-    { // 遍历子宫 3 行
-        for (int j = sc; j < sc + SUB_SIZE; ++j)
-        { // 遍历子宫 3 列
-            if (board[i][j] == num)
-                return false; // 子宫内已出现 num
-        }
-    }
-    return true; // 三个维度均合法
-}
-
 // 找到下一个空格；虽然 GA 不逐格填数，但保留接口
 bool findEmpty(const vector<vector<int>> &board, int &row, int &col)
 {
@@ -128,41 +103,32 @@ void initBoardBlockWise(vector<vector<int>> &b,
 }
 
 // 统计一行的“重复冲突数”：某个数字出现次数>1，则多出的次数记为冲突
+// 多出的次数之和 = 已填格数 - 出现过的不同数字个数，后者就是掩码的 popcount
 int countRowConflicts(const vector<vector<int>> &b, int r)
 {
-    int cnt[10] = {0}; // 统计 1..9 频次
-    int conf = 0;      // 行冲突计数
+    uint16_t seen = 0; // 出现过的数字掩码
+    int filled = 0;    // 已填格数
     for (int c = 0; c < SIZE; ++c)
     {                    // 遍历该行
         int v = b[r][c]; // 当前值
         if (v >= 1 && v <= 9)
-            ++cnt[v]; // 计数
+            seen |= 1 << (v - 1), ++filled; // 记录
     }
-    for (int d = 1; d <= 9; ++d)
-    { // 遍历 1..9
-        if (cnt[d] > 1)
-            conf += (cnt[d] - 1); // 多出的都算冲突
-    }
-    return conf; // 返回本行冲突数
+    return filled - __builtin_popcount(seen); // 返回本行冲突数
 }
 
 // 统计一列的“重复冲突数”（与行同理）
 int countColConflicts(const vector<vector<int>> &b, int c)
 {
-    int cnt[10] = {0}; // 统计 1..9 频次
-    int conf = 0;      // 列冲突计数
+    uint16_t seen = 0; // 出现过的数字掩码
+    int filled = 0;    // 已填格数
     for (int r = 0; r < SIZE; ++r)
     {                    // 遍历该列
         int v = b[r][c]; // 当前值
         if (v >= 1 && v <= 9)
-            ++cnt[v]; // 计数
-    }
-    for (int d = 1; d <= 9; ++d)
-    { // 遍历 1..9
-        if (cnt[d] > 1)
-            conf += (cnt[d] - 1); // 多出的都算冲突
+            seen |= 1 << (v - 1), ++filled; // 记录
     }
-    return conf; // 返回本列冲突数
+    return filled - __builtin_popcount(seen); // 返回本列冲突数
 }
 
 // 全局冲突 = 所有行冲突 + 所有列冲突（宫内已保证合法，不需要计入）
@@ -388,6 +354,11 @@ int main()
     printBoard(sampleInput);      // 输出棋盘
     cout << endl;                 // 空行
 
+    // 题面自身的行/列/宫校验：有重复时 GA 不可能达到零冲突，先给出提示
+    SudokuMask mask;
+    if (!mask.init(sampleInput))
+        cout << "注意：题面的行/列/宫中已有重复数字，不存在零冲突的解。" << endl << endl;
+
     // 设置 GA 参数（可按需调整）
     GAParams P;          // 使用默认值
     P.pop = 200;         // 种群规模
@@ -0,0 +1,1749 @@
+#pragma once
+// 滑块拼图公共部分：压缩棋盘、排列编号、可达性判定、路径回溯与打印、IDA*、模式数据库
+#include <bits/stdc++.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+// R行C列的滑块棋盘（3×3 八数码、4×4 十五数码、5×5 二十四数码）。
+// 每格占BITS位压在一个整数里：第i格在第 BITS*i 位起，空格为0，数字为1..R*C-1。
+// 16格以内每格4位放进 uint64_t，25格每格5位放进128位整数。
+// 空格位置单独缓存；移动就是把相邻格的数字异或到空格处，哈希直接对整数做。
+// 字符串形式只在输入输出时使用：9格以内是 "1238_4765" 这样的字符，更大的棋盘是空格分隔的数字，0或_表示空格。
+template <int R, int C>
+struct BoardT
+{
+    static constexpr int N = R * C;
+    static constexpr int BITS = N <= 16 ? 4 : 5;
+    typedef typename conditional<(N <= 16), uint64_t, unsigned __int128>::type word_t;
+
+    word_t v;
+    int z; // 空格位置
+
+    // 默认目标：八数码沿用 "1238_4765"，其余为 1..N-1 后接空格；格式与构造函数一致（9格以内每格一个字符）
+    static string default_goal()
+    {
+        if (R == 3 && C == 3)
+            return "1238_4765";
+        string g;
+        for (int i = 1; i < N; i++)
+            g += to_string(i) + (N > 9 ? " " : "");
+        return g + "_";
+    }
+
+    // 无法解析的字符或数字（非数字、超出每格位数）不抛异常，得到全0的棋盘，由 valid() 拒绝
+    BoardT(const string &t = default_goal()) : v(0), z(0)
+    {
+        if (N <= 9)
+        {
+            for (int i = 0; i < N && i < (int)t.size(); i++)
+            {
+                if (t[i] != '_' && !isdigit((unsigned char)t[i]))
+                {
+                    clear();
+                    return;
+                }
+                set(i, t[i] == '_' ? 0 : t[i] - '0');
+            }
+            return;
+        }
+        istringstream in(t);
+        string tok;
+        for (int i = 0; i < N && in >> tok; i++)
+        {
+            if (tok == "_")
+            {
+                set(i, 0);
+                continue;
+            }
+            if (tok.size() > 2 || !all_of(tok.begin(), tok.end(), [](char c) { return isdigit((unsigned char)c); }) ||
+                stoi(tok) >= (1 << BITS))
+            {
+                clear();
+                return;
+            }
+            set(i, stoi(tok));
+        }
+    }
+    int blank_pos() const { return z; }
+
+    // 0..N-1 每个数字恰好出现一次，且 str() 能原样解析回来
+    bool valid() const
+    {
+        uint32_t seen = 0;
+        for (int i = 0; i < N; i++)
+            seen |= 1u << tile(i);
+        return seen == (uint32_t)((1ull << N) - 1) && tile(z) == 0 && BoardT(str()) == *this;
+    }
+    int tile(int i) const { return (int)(v >> (BITS * i)) & ((1 << BITS) - 1); }
+    bool operator==(const BoardT &o) const { return v == o.v; }
+
+    // 原地把第nz格的数字移到空格z，空格移到nz；再对原来的空格位置调用一次即可撤销
+    void apply(int nz)
+    {
+        word_t t = (v >> (BITS * nz)) & ((1 << BITS) - 1);
+        v ^= (t << (BITS * nz)) | (t << (BITS * z));
+        z = nz;
+    }
+
+    BoardT moved(int nz) const
+    {
+        BoardT nb = *this;
+        nb.apply(nz);
+        return nb;
+    }
+
+    // 空格朝方向k（0上 1下 2左 3右）移动后的位置，出界时返回-1；k^1 是反方向
+    int target(int k) const
+    {
+        static const int dr[4] = {-1, 1, 0, 0}, dc[4] = {0, 0, -1, 1};
+        int nr = z / C + dr[k], nc = z % C + dc[k];
+        if (nr < 0 || nr >= R || nc < 0 || nc >= C)
+            return -1;
+        return nr * C + nc;
+    }
+
+    vector<BoardT> neighbors() const
+    {
+        vector<BoardT> res;
+        for (int k = 0; k < 4; k++)
+        {
+            int nz = target(k);
+            if (nz >= 0)
+                res.push_back(moved(nz));
+        }
+        return res;
+    }
+
+    // 与字符串字典序一致的比较键（'_' 的ASCII码大于数字，所以空格按最大值算），第0格在最高位
+    word_t order_key() const
+    {
+        word_t k = 0;
+        for (int i = 0; i < N; i++)
+            k = (k << BITS) | (word_t)(i == z ? (1 << BITS) - 1 : tile(i));
+        return k;
+    }
+
+    string str() const
+    {
+        string s;
+        for (int i = 0; i < N; i++)
+        {
+            if (N > 9 && i)
+                s += ' ';
+            s += i == z ? string("_") : to_string(tile(i));
+        }
+        return s;
+    }
+
+    string to_grid() const
+    {
+        string out;
+        for (int i = 0; i < N; i++)
+        {
+            string cell = i == z ? string("_") : to_string(tile(i));
+            if (N > 9 && cell.size() < 2)
+                cell = " " + cell;
+            out += cell;
+            if (i % C != C - 1)
+                out.push_back(' ');
+            if (i % C == C - 1 && i != N - 1)
+                out.push_back('\n');
+        }
+        return out;
+    }
+
+private:
+    void clear() { v = 0, z = 0; }
+    void set(int i, int t)
+    {
+        if (t == 0)
+            z = i;
+        v |= (word_t)t << (BITS * i);
+    }
+};
+
+typedef BoardT<3, 3> Board;
+
+// 空格在第i格时朝方向k（0上 1下 2左 3右）移动到的格，出界为-1；编译期生成，搜索内层直接查表
+template <int R, int C>
+struct MoveTable
+{
+    int8_t to[R * C][4];
+    constexpr MoveTable() : to()
+    {
+        for (int i = 0; i < R * C; i++)
+        {
+            int r = i / C, c = i % C;
+            to[i][0] = (int8_t)(r > 0 ? i - C : -1);
+            to[i][1] = (int8_t)(r < R - 1 ? i + C : -1);
+            to[i][2] = (int8_t)(c > 0 ? i - 1 : -1);
+            to[i][3] = (int8_t)(c < C - 1 ? i + 1 : -1);
+        }
+    }
+};
+template <int R, int C>
+inline constexpr MoveTable<R, C> MOVES{};
+
+// unordered_set/map 用的整数哈希（splitmix64 的混合步骤）
+struct BoardHash
+{
+    size_t operator()(uint64_t x) const
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return (size_t)x;
+    }
+    size_t operator()(unsigned __int128 x) const { return (*this)((uint64_t)x ^ (*this)((uint64_t)(x >> 64))); }
+    template <int R, int C>
+    size_t operator()(const BoardT<R, C> &b) const { return (*this)(b.v); }
+};
+
+// ---------------- 排列编号 ----------------
+// 9格的内容是0..8的一个排列，用Lehmer码把它映射到 [0, 9!) 的稠密编号，
+// 这样visited可以用位数组、父节点可以用每状态2位的移动方向数组，查找就是数组下标。
+#define PUZZLE_STATES 362880 // 9!
+
+static const int FACT[10] = {1, 1, 2, 6, 24, 120, 720, 5040, 40320, 362880};
+
+inline uint32_t board_rank(const Board &b)
+{
+    uint32_t r = 0, used = 0;
+    for (int i = 0; i < 9; i++)
+    {
+        int x = b.tile(i);
+        // 比x小且还没用过的数的个数
+        int d = x - __builtin_popcount(used & ((1u << x) - 1));
+        r += d * FACT[8 - i];
+        used |= 1u << x;
+    }
+    return r;
+}
+
+inline Board board_unrank(uint32_t r)
+{
+    Board b;
+    b.v = 0;
+    uint32_t used = 0;
+    for (int i = 0; i < 9; i++)
+    {
+        int d = r / FACT[8 - i];
+        r %= FACT[8 - i];
+        // 第d个（从0数）未用过的数
+        uint32_t free = ~used & 0x1ff;
+        while (d--)
+            free &= free - 1;
+        int x = __builtin_ctz(free);
+        used |= 1u << x;
+        if (x == 0)
+            b.z = i;
+        b.v |= (uint64_t)x << (4 * i);
+    }
+    return b;
+}
+
+// 按编号索引的访问标记，每状态1位
+struct VisitedBits
+{
+    vector<uint64_t> w;
+    VisitedBits(size_t n = PUZZLE_STATES) : w((n + 63) / 64, 0) {}
+    bool test(uint32_t i) const { return (w[i >> 6] >> (i & 63)) & 1; }
+    // 置位，原来没置位时返回true
+    bool insert(uint32_t i)
+    {
+        uint64_t m = 1ULL << (i & 63);
+        bool fresh = !(w[i >> 6] & m);
+        w[i >> 6] |= m;
+        return fresh;
+    }
+};
+
+// 按编号索引的移动方向，每状态2位：记录空格走哪个方向到达该状态
+struct MoveArray
+{
+    vector<uint8_t> a;
+    MoveArray(size_t n = PUZZLE_STATES) : a((n + 3) / 4, 0) {}
+    int get(uint32_t i) const { return (a[i >> 2] >> (2 * (i & 3))) & 3; }
+    void set(uint32_t i, int k)
+    {
+        a[i >> 2] = (uint8_t)((a[i >> 2] & ~(3 << (2 * (i & 3)))) | (k << (2 * (i & 3))));
+    }
+};
+
+// 可达性判定
+template <int R, int C>
+int inversion_count(const BoardT<R, C> &b)
+{
+    int a[BoardT<R, C>::N], m = 0, inv = 0;
+    for (int i = 0; i < BoardT<R, C>::N; i++)
+        if (i != b.z)
+            a[m++] = b.tile(i);
+    for (int i = 0; i < m; i++)
+        for (int j = i + 1; j < m; j++)
+            if (a[i] > a[j])
+                inv++;
+    return inv;
+}
+// 列数为奇数时横向、纵向移动都不改变逆序数奇偶；列数为偶数时纵向移动会改变，需要加上空格所在行
+template <int R, int C>
+bool solvable(const BoardT<R, C> &s, const BoardT<R, C> &g)
+{
+    int ps = inversion_count(s), pg = inversion_count(g);
+    if (C % 2 == 0)
+        ps += s.z / C, pg += g.z / C;
+    return ps % 2 == pg % 2;
+}
+
+// 解写成空格的移动串：U上 D下 L左 R右，与方向编号 0..3 对应
+static const char MOVE_CHARS[] = "UDLR";
+
+// 回溯移动串：从终点开始按记录的方向反着走（k^1），直到回到起点；只维护当前棋盘，不保存中间状态
+inline string reconstruct_moves(const Board &start, const Board &goal, const MoveArray &parent)
+{
+    string moves;
+    Board cur = goal;
+    while (!(cur == start))
+    {
+        int k = parent.get(board_rank(cur));
+        moves.push_back(MOVE_CHARS[k]);
+        cur.apply(cur.target(k ^ 1));
+    }
+    reverse(moves.begin(), moves.end());
+    return moves;
+}
+
+// 相邻棋盘序列对应的移动串
+template <int R, int C>
+string path_moves(const vector<BoardT<R, C>> &path)
+{
+    string moves;
+    for (int i = 1; i < (int)path.size(); i++)
+        for (int k = 0; k < 4; k++)
+            if (path[i - 1].target(k) == path[i].z)
+                moves.push_back(MOVE_CHARS[k]);
+    return moves;
+}
+
+// 从起点按移动串重放出每一步的棋盘，只在需要打印棋盘时调用
+template <int R, int C>
+vector<BoardT<R, C>> replay(const BoardT<R, C> &start, const string &moves)
+{
+    vector<BoardT<R, C>> seq(1, start);
+    for (char m : moves)
+        seq.push_back(seq.back().moved(seq.back().target((int)(strchr(MOVE_CHARS, m) - MOVE_CHARS))));
+    return seq;
+}
+
+inline vector<Board> reconstruct(const Board &start, const Board &goal, const MoveArray &parent)
+{
+    return replay(start, reconstruct_moves(start, goal, parent));
+}
+
+// 打印路径
+template <int R, int C>
+void print_path(const vector<BoardT<R, C>> &path)
+{
+    for (int i = 0; i < (int)path.size(); i++)
+    {
+        cout << "Step " << i << ":\n"
+             << path[i].to_grid() << "\n\n";
+    }
+}
+
+// ---------------- IDA*（曼哈顿距离 + 线性冲突） ----------------
+// 迭代加深A*：每轮只做一次有f上限的深度优先搜索，内存只和深度成正比。
+// 启发函数 h = 曼哈顿距离 + 线性冲突，两者都可采纳：
+// 同一行（列）里目标也在该行（列）的两块数字顺序颠倒时，至少有一块要先离开再回来，多走2步。
+// 移动一块数字只改变它自己的曼哈顿距离，以及它离开/进入的两条线的线性冲突，所以每步增量更新。
+//
+// 启发函数类需要提供 Eval（可复制的缓存，随搜索栈保存/恢复）、init(b)、after(ev, b, t, from, to, k)。
+template <int R, int C>
+struct HeuristicT
+{
+    typedef BoardT<R, C> B;
+    int gr[B::N], gc[B::N]; // 每个数字在目标中的行、列
+
+    struct Eval
+    {
+        int h;
+        int lc[R + C]; // 各条线的线性冲突：0..R-1 为行，R..R+C-1 为列
+    };
+
+    HeuristicT(const B &goal)
+    {
+        for (int i = 0; i < B::N; i++)
+            gr[goal.tile(i)] = i / C, gc[goal.tile(i)] = i % C;
+    }
+
+    int manhattan(int t, int cell) const { return abs(cell / C - gr[t]) + abs(cell % C - gc[t]); }
+
+    int line_cost(const B &b, int line) const
+    {
+        int key[R > C ? R : C], m = 0;
+        int len = line < R ? C : R;
+        for (int j = 0; j < len; j++)
+        {
+            int cell = line < R ? line * C + j : j * C + (line - R);
+            int t = b.tile(cell);
+            if (t == 0)
+                continue;
+            if (line < R && gr[t] == line)
+                key[m++] = gc[t];
+            else if (line >= R && gc[t] == line - R)
+                key[m++] = gr[t];
+        }
+        // 保持不动的最多块数 = 目标位置序列的最长上升子序列
+        int lis[R > C ? R : C], best = 0;
+        for (int i = 0; i < m; i++)
+        {
+            lis[i] = 1;
+            for (int j = 0; j < i; j++)
+                if (key[j] < key[i])
+                    lis[i] = max(lis[i], lis[j] + 1);
+            best = max(best, lis[i]);
+        }
+        return 2 * (m - best);
+    }
+
+    Eval init(const B &b) const
+    {
+        Eval e;
+        e.h = 0;
+        for (int i = 0; i < B::N; i++)
+            if (i != b.z)
+                e.h += manhattan(b.tile(i), i);
+        for (int line = 0; line < R + C; line++)
+            e.h += e.lc[line] = line_cost(b, line);
+        return e;
+    }
+
+    int operator()(const B &b) const { return init(b).h; }
+
+    // 数字t从from移到to（b为移动后的棋盘，k为空格方向）：垂直移动改变两行，水平移动改变两列
+    Eval after(const Eval &e, const B &b, int t, int from, int to, int k) const
+    {
+        Eval n = e;
+        int l1 = k < 2 ? from / C : R + from % C, l2 = k < 2 ? to / C : R + to % C;
+        n.lc[l1] = line_cost(b, l1);
+        n.lc[l2] = line_cost(b, l2);
+        n.h += manhattan(t, to) - manhattan(t, from) - e.lc[l1] - e.lc[l2] + n.lc[l1] + n.lc[l2];
+        return n;
+    }
+};
+
+typedef HeuristicT<3, 3> Heuristic;
+
+template <int R, int C, class H = HeuristicT<R, C>>
+class IdaStarT
+{
+public:
+    typedef BoardT<R, C> B;
+    long long expanded;
+
+    // 使用由目标构造的启发函数（曼哈顿 + 线性冲突）
+    IdaStarT(const B &goal) : expanded(0), goal(goal), owned(new H(goal)), h(owned.get()) {}
+    // 使用外部准备好的启发函数（如已加载的模式数据库），调用者保证其生命周期
+    IdaStarT(const B &goal, const H &heur) : expanded(0), goal(goal), h(&heur) {}
+
+    // 返回最优路径（含起点），无解时返回空
+    vector<B> solve(const B &start)
+    {
+        if (!solvable(start, goal))
+            return vector<B>();
+        b = start;
+        typename H::Eval e = h->init(b);
+        moves.clear();
+        for (int bound = e.h;;)
+        {
+            int t = search(0, e, bound, -1);
+            if (t < 0)
+                break;
+            bound = t;
+        }
+        vector<B> path(1, start);
+        for (int k : moves)
+            path.push_back(path.back().moved(path.back().target(k)));
+        return path;
+    }
+
+private:
+    B goal, b; // b 是唯一一块可变的棋盘，前进时移动、回溯时移回
+    unique_ptr<H> owned;
+    const H *h;
+    vector<int> moves;
+
+    // 找到解返回-1，否则返回超过bound的最小f
+    int search(int g, const typename H::Eval &e, int bound, int prev)
+    {
+        int f = g + e.h;
+        if (f > bound)
+            return f;
+        if (b == goal)
+            return -1;
+        expanded++;
+        int next_bound = INT_MAX;
+        for (int k = 0; k < 4; k++)
+        {
+            if (k == (prev ^ 1)) // 不立即走回头路
+                continue;
+            int from = b.target(k);
+            if (from < 0)
+                continue;
+            int to = b.z, t = b.tile(from);
+            b = b.moved(from);
+            moves.push_back(k);
+            int r = search(g + 1, h->after(e, b, t, from, to, k), bound, k);
+            if (r < 0)
+                return -1;
+            moves.pop_back();
+            b = b.moved(to);
+            next_bound = min(next_bound, r);
+        }
+        return next_bound;
+    }
+};
+
+typedef IdaStarT<3, 3> IdaStar;
+
+// ---------------- 随机实例 ----------------
+// 均匀随机打乱，直到与目标奇偶性相同
+template <int R, int C>
+BoardT<R, C> random_board(const BoardT<R, C> &goal, mt19937 &rng)
+{
+    typedef BoardT<R, C> B;
+    vector<int> t(B::N);
+    iota(t.begin(), t.end(), 0);
+    while (true)
+    {
+        shuffle(t.begin(), t.end(), rng);
+        string s;
+        for (int i = 0; i < B::N; i++)
+        {
+            if (B::N > 9 && i)
+                s += ' ';
+            s += t[i] ? to_string(t[i]) : string("_");
+        }
+        B b(s);
+        if (solvable(b, goal))
+            return b;
+    }
+}
+
+// 最优距离恰为 depth 的随机实例：从目标出发随机向外走，每步只走距离加一的邻居。
+// 状态图是二部图，邻居的距离只能是 d±1：启发值已超过 d-1 的一定是 d+1，否则用IDA*求一次确切距离。
+// 走到没有更远的邻居时退回上一步换一个方向（随机顺序的深度优先），走过的死路记下不再进入；
+// depth 超过直径、或试过 max_nodes 个状态仍未到达时返回false
+template <int R, int C, class H>
+bool random_board_at(const BoardT<R, C> &goal, int depth, mt19937 &rng, const H &heur, BoardT<R, C> &out,
+                     long long max_nodes = 1000000)
+{
+    typedef BoardT<R, C> B;
+    struct Frame
+    {
+        B s;
+        int order[4], next;
+    };
+    vector<Frame> st(1);
+    unordered_set<typename B::word_t, BoardHash> seen;
+    auto enter = [&](Frame &f)
+    {
+        for (int i = 0; i < 4; i++)
+            f.order[i] = i;
+        shuffle(f.order, f.order + 4, rng);
+        f.next = 0;
+    };
+    st[0].s = goal;
+    enter(st[0]);
+    seen.insert(goal.v);
+    while (!st.empty() && (long long)seen.size() < max_nodes)
+    {
+        int d = (int)st.size() - 1;
+        if (d == depth)
+        {
+            out = st.back().s;
+            return true;
+        }
+        Frame &f = st.back();
+        if (f.next == 4)
+        {
+            st.pop_back();
+            continue;
+        }
+        int nz = f.s.target(f.order[f.next++]);
+        if (nz < 0)
+            continue;
+        B t = f.s.moved(nz);
+        if (!seen.insert(t.v).second)
+            continue;
+        if (heur.init(t).h > d - 1 || (int)IdaStarT<R, C, H>(goal, heur).solve(t).size() - 1 == d + 1)
+        {
+            Frame g;
+            g.s = t;
+            enter(g);
+            st.push_back(g);
+        }
+    }
+    return false;
+}
+
+// ---------------- 加性模式数据库 ----------------
+// 把数字分成互不相交的几组，每组只关心本组数字的位置，其他数字看作可以任意穿过的空白：
+// 本组数字移到相邻的非本组格子算一步。从目标出发做一次BFS（移动可逆，等价于逆向BFS），
+// 得到每种位置组合到目标的最少步数。每一步只移动一块数字，只属于一组，所以各组的值相加仍可采纳。
+// 位置组合按部分排列编号：k块数字在N格中的有序位置，编号范围 [0, N!/(N-k)!)。
+template <int R, int C>
+struct PatternDB
+{
+    typedef BoardT<R, C> B;
+    static constexpr int N = B::N;
+    vector<int> tiles;   // 本组的数字
+    vector<int> goalpos; // 它们在目标中的位置
+    vector<uint8_t> dist;
+
+    PatternDB() {}
+    PatternDB(const vector<int> &tiles, const B &goal) : tiles(tiles)
+    {
+        for (int t : tiles)
+            for (int i = 0; i < N; i++)
+                if (goal.tile(i) == t)
+                    goalpos.push_back(i);
+    }
+
+    size_t size() const
+    {
+        size_t n = 1;
+        for (int i = 0; i < (int)tiles.size(); i++)
+            n *= N - i;
+        return n;
+    }
+
+    size_t rank(const int *pos) const
+    {
+        size_t r = 0;
+        uint32_t used = 0;
+        for (int i = 0; i < (int)tiles.size(); i++)
+        {
+            int d = pos[i] - __builtin_popcount(used & ((1u << pos[i]) - 1));
+            r = r * (N - i) + d;
+            used |= 1u << pos[i];
+        }
+        return r;
+    }
+
+    void unrank(size_t r, int *pos) const
+    {
+        int k = (int)tiles.size(), d[N];
+        for (int i = k - 1; i >= 0; i--)
+        {
+            d[i] = (int)(r % (N - i));
+            r /= N - i;
+        }
+        uint32_t used = 0;
+        for (int i = 0; i < k; i++)
+        {
+            uint32_t free = ~used & ((1u << N) - 1);
+            for (int j = 0; j < d[i]; j++)
+                free &= free - 1;
+            pos[i] = __builtin_ctz(free);
+            used |= 1u << pos[i];
+        }
+    }
+
+    // 从目标位置出发BFS，填满 dist
+    void build()
+    {
+        static const int dr[4] = {-1, 1, 0, 0}, dc[4] = {0, 0, -1, 1};
+        int k = (int)tiles.size();
+        dist.assign(size(), 0xff);
+        vector<uint32_t> q;
+        q.reserve(size());
+        size_t r0 = rank(goalpos.data());
+        dist[r0] = 0;
+        q.push_back((uint32_t)r0);
+        int pos[N];
+        for (size_t head = 0; head < q.size(); head++)
+        {
+            unrank(q[head], pos);
+            uint8_t d = dist[q[head]];
+            uint32_t occ = 0;
+            for (int i = 0; i < k; i++)
+                occ |= 1u << pos[i];
+            for (int i = 0; i < k; i++)
+            {
+                int p = pos[i];
+                for (int m = 0; m < 4; m++)
+                {
+                    int nr = p / C + dr[m], nc = p % C + dc[m];
+                    if (nr < 0 || nr >= R || nc < 0 || nc >= C || (occ >> (nr * C + nc) & 1))
+                        continue;
+                    pos[i] = nr * C + nc;
+                    size_t nrk = rank(pos);
+                    if (dist[nrk] == 0xff)
+                    {
+                        dist[nrk] = (uint8_t)(d + 1);
+                        q.push_back((uint32_t)nrk);
+                    }
+                }
+                pos[i] = p;
+            }
+        }
+    }
+
+    // 本组在棋盘b上的下界
+    int lookup(const B &b) const
+    {
+        int where[N], pos[N];
+        for (int i = 0; i < N; i++)
+            where[b.tile(i)] = i;
+        for (int i = 0; i < (int)tiles.size(); i++)
+            pos[i] = where[tiles[i]];
+        return dist[rank(pos)];
+    }
+
+    // 文件格式（小端）："PDB1"，R，C，k，k个数字，k个目标位置，8字节表长，4字节FNV-1a校验和，之后每状态1字节
+    uint32_t checksum() const
+    {
+        uint32_t x = 2166136261u;
+        for (uint8_t c : dist)
+            x = (x ^ c) * 16777619u;
+        return x;
+    }
+
+    bool save(const string &path) const
+    {
+        FILE *fp = fopen(path.c_str(), "wb");
+        if (!fp)
+            return false;
+        uint8_t head[3] = {(uint8_t)R, (uint8_t)C, (uint8_t)tiles.size()};
+        fwrite("PDB1", 1, 4, fp);
+        fwrite(head, 1, 3, fp);
+        for (int t : tiles)
+            fputc(t, fp);
+        for (int g : goalpos)
+            fputc(g, fp);
+        uint64_t n = dist.size();
+        uint32_t sum = checksum();
+        fwrite(&n, sizeof n, 1, fp);
+        fwrite(&sum, sizeof sum, 1, fp);
+        bool ok = fwrite(dist.data(), 1, dist.size(), fp) == dist.size();
+        return fclose(fp) == 0 && ok;
+    }
+
+    // 读取并校验：尺寸、数字分组、目标位置和校验和都必须与当前一致
+    bool load(const string &path)
+    {
+        FILE *fp = fopen(path.c_str(), "rb");
+        if (!fp)
+            return false;
+        char magic[4];
+        uint8_t head[3];
+        bool ok = fread(magic, 1, 4, fp) == 4 && memcmp(magic, "PDB1", 4) == 0 &&
+                  fread(head, 1, 3, fp) == 3 && head[0] == R && head[1] == C && head[2] == tiles.size();
+        for (int i = 0; ok && i < (int)tiles.size(); i++)
+            ok = fgetc(fp) == tiles[i];
+        for (int i = 0; ok && i < (int)goalpos.size(); i++)
+            ok = fgetc(fp) == goalpos[i];
+        uint64_t n = 0;
+        uint32_t sum = 0;
+        ok = ok && fread(&n, sizeof n, 1, fp) == 1 && fread(&sum, sizeof sum, 1, fp) == 1 && n == size();
+        if (ok)
+        {
+            dist.resize(n);
+            ok = fread(dist.data(), 1, n, fp) == n && checksum() == sum;
+        }
+        fclose(fp);
+        if (!ok)
+            dist.clear();
+        return ok;
+    }
+};
+
+// 若干组互不相交的模式数据库之和，可作为 IdaStarT 的启发函数。
+// 方形棋盘且目标的空格在主对角线上时，把棋盘沿主对角线翻转并按目标重新编号后得到的状态
+// 与原状态到目标的距离相同，因此同一组数据库再查一次翻转后的状态，取两者较大值。
+template <int R, int C>
+struct AdditivePDB
+{
+    typedef BoardT<R, C> B;
+    static constexpr int MAXP = 8;
+    vector<PatternDB<R, C>> parts;
+    int owner[B::N]; // 每个数字属于哪一组
+    bool mirror;     // 是否使用翻转查表
+    int refl[B::N];  // 翻转后数字t对应的数字
+
+    struct Eval
+    {
+        int h, sum, msum;
+        int part[MAXP], mpart[MAXP]; // 各组直接查表和翻转查表的值
+        uint8_t pos[B::N];           // 每个数字所在的格子，随移动只改一项
+    };
+
+    // 默认分组：3×3 为 4-4，4×4 为 6-6-3，5×5 为 5-5-5-5-4（按数字编号，与目标布局无关）
+    static vector<vector<int>> default_groups()
+    {
+        if (R == 3 && C == 3)
+            return {{1, 2, 3, 4}, {5, 6, 7, 8}};
+        if (R == 4 && C == 4)
+            return {{1, 2, 5, 6, 9, 13}, {3, 4, 7, 8, 11, 12}, {10, 14, 15}};
+        if (R == 5 && C == 5)
+            return {{1, 2, 6, 7, 11}, {3, 4, 5, 8, 9}, {10, 14, 15, 19, 20}, {12, 13, 16, 17, 18}, {21, 22, 23, 24}};
+        vector<vector<int>> g(1);
+        for (int t = 1; t < B::N; t++)
+        {
+            if (g.back().size() == 5)
+                g.emplace_back();
+            g.back().push_back(t);
+        }
+        return g;
+    }
+
+    AdditivePDB(const B &goal, const vector<vector<int>> &groups = default_groups())
+    {
+        for (auto &g : groups)
+            parts.emplace_back(g, goal);
+        for (int i = 0; i < (int)parts.size(); i++)
+            for (int t : parts[i].tiles)
+                owner[t] = i;
+        mirror = R == C && transpose(goal.z) == goal.z;
+        for (int i = 0; mirror && i < B::N; i++)
+            refl[goal.tile(i)] = goal.tile(transpose(i));
+    }
+
+    static int transpose(int cell) { return (cell % C) * C + cell / C; }
+
+    static string file_name(const string &prefix, int i)
+    {
+        return prefix + "." + to_string(R) + "x" + to_string(C) + "." + to_string(i) + ".pdb";
+    }
+
+    // 加载 prefix.RxC.i.pdb；缺失或不匹配的组现场生成并写回文件
+    bool prepare(const string &prefix)
+    {
+        bool ok = true;
+        for (int i = 0; i < (int)parts.size(); i++)
+        {
+            if (parts[i].load(file_name(prefix, i)))
+                continue;
+            parts[i].build();
+            ok = parts[i].save(file_name(prefix, i)) && ok;
+        }
+        return ok;
+    }
+
+    // 第p组在b上的值；mirrored 时查翻转后的状态
+    int part_value(const uint8_t *where, int p, bool mirrored) const
+    {
+        const PatternDB<R, C> &db = parts[p];
+        int pos[B::N];
+        for (int i = 0; i < (int)db.tiles.size(); i++)
+            pos[i] = mirrored ? transpose(where[refl[db.tiles[i]]]) : where[db.tiles[i]];
+        return db.dist[db.rank(pos)];
+    }
+
+    Eval init(const B &b) const
+    {
+        Eval e;
+        for (int i = 0; i < B::N; i++)
+            e.pos[b.tile(i)] = (uint8_t)i;
+        e.sum = e.msum = 0;
+        for (int i = 0; i < (int)parts.size(); i++)
+        {
+            e.sum += e.part[i] = part_value(e.pos, i, false);
+            if (mirror)
+                e.msum += e.mpart[i] = part_value(e.pos, i, true);
+        }
+        e.h = max(e.sum, e.msum);
+        return e;
+    }
+
+    int operator()(const B &b) const { return init(b).h; }
+
+    // 只有被移动数字所在的那一组（翻转后则是它对应数字所在的组）需要重新查表，位置表只改t和空格两项
+    Eval after(const Eval &e, const B &, int t, int from, int to, int) const
+    {
+        Eval n = e;
+        n.pos[t] = (uint8_t)to;
+        n.pos[0] = (uint8_t)from;
+        int p = owner[t];
+        n.part[p] = part_value(n.pos, p, false);
+        n.sum += n.part[p] - e.part[p];
+        if (mirror)
+        {
+            int mp = owner[refl[t]];
+            n.mpart[mp] = part_value(n.pos, mp, true);
+            n.msum += n.mpart[mp] - e.mpart[mp];
+        }
+        n.h = max(n.sum, n.msum);
+        return n;
+    }
+};
+
+// ---------------- 八数码完整距离表 ----------------
+// 从目标出发做一次BFS，遍历全部 9!/2 = 181440 个可达状态，每个状态按排列编号存一个4位距离。
+// 最远距离31超过4位，所以存的是 距离 mod 15，15 表示不可达。相邻状态的距离恰好相差1，
+// d-1 与 d+1 模15不同，因此从起点出发每步走到值为 (v-1) mod 15 的邻居，就是一条最短路。
+//
+// 距离表可以存成文件，之后用 mmap 只读映射，启动时不需要重新BFS，多个进程共享页缓存里的同一份。
+// 文件格式（小端）：64字节文件头，之后是 9!/2 字节的距离数据（每字节两个状态，低4位在前）。
+struct DistanceTableHeader
+{
+    char magic[8];         // "8PUZDT\0\0"
+    uint32_t version;      // 1
+    uint32_t rank_scheme;  // 1 = Lehmer码，[0, 9!)
+    uint32_t entry_bits;   // 4
+    uint32_t modulus;      // 15
+    char goal[16];         // 目标状态字符串，如 "1238_4765"
+    uint64_t states;       // 9!
+    uint64_t data_bytes;
+    uint32_t checksum;     // 数据部分的 FNV-1a
+    uint32_t reserved;
+};
+
+struct DistanceTable
+{
+    static constexpr int UNREACHED = 15;
+    static constexpr uint32_t VERSION = 1;
+    Board goal;
+
+    DistanceTable(const Board &goal) : goal(goal), own((PUZZLE_STATES + 1) / 2, 0xff), mapped(NULL), mapped_len(0)
+    {
+        nib = own.data();
+        vector<uint32_t> q;
+        q.reserve(PUZZLE_STATES / 2);
+        q.push_back(board_rank(goal));
+        set(q[0], 0);
+        for (size_t head = 0; head < q.size(); head++)
+        {
+            Board u = board_unrank(q[head]);
+            int nd = (get(q[head]) + 1) % 15;
+            for (int k = 0; k < 4; k++)
+            {
+                int nz = u.target(k);
+                if (nz < 0)
+                    continue;
+                uint32_t rv = board_rank(u.moved(nz));
+                if (get(rv) == UNREACHED)
+                {
+                    set(rv, nd);
+                    q.push_back(rv);
+                }
+            }
+        }
+    }
+
+    ~DistanceTable()
+    {
+#ifndef _WIN32
+        if (mapped)
+            munmap(mapped, mapped_len);
+#endif
+    }
+    DistanceTable(const DistanceTable &) = delete;
+    DistanceTable &operator=(const DistanceTable &) = delete;
+
+    int get(uint32_t r) const { return (nib[r >> 1] >> (4 * (r & 1))) & 15; }
+
+    bool reachable(const Board &s) const { return get(board_rank(s)) != UNREACHED; }
+
+    // 贪心下降得到最优路径（含起点），不可达时返回空；
+    // 某步找不到值为 v-1 的邻居、或走了超过最远距离31步仍未到目标（表损坏）时也返回空，不在原地打转
+    vector<Board> path(const Board &start) const
+    {
+        vector<Board> seq;
+        if (!reachable(start))
+            return seq;
+        Board cur = start;
+        seq.push_back(cur);
+        while (!(cur == goal))
+        {
+            int want = (get(board_rank(cur)) + 14) % 15, k = 0;
+            for (; k < 4; k++)
+            {
+                int nz = cur.target(k);
+                if (nz >= 0 && get(board_rank(cur.moved(nz))) == want)
+                    break;
+            }
+            if (k == 4 || seq.size() > 31)
+                return vector<Board>();
+            cur = cur.moved(cur.target(k));
+            seq.push_back(cur);
+        }
+        return seq;
+    }
+
+    static uint32_t checksum(const uint8_t *p, size_t n)
+    {
+        uint32_t x = 2166136261u;
+        for (size_t i = 0; i < n; i++)
+            x = (x ^ p[i]) * 16777619u;
+        return x;
+    }
+
+    static DistanceTableHeader make_header(const Board &goal)
+    {
+        DistanceTableHeader h;
+        memset(&h, 0, sizeof h);
+        memcpy(h.magic, "8PUZDT", 6);
+        h.version = VERSION;
+        h.rank_scheme = 1;
+        h.entry_bits = 4;
+        h.modulus = 15;
+        string g = goal.str();
+        memcpy(h.goal, g.data(), g.size());
+        h.states = PUZZLE_STATES;
+        h.data_bytes = (PUZZLE_STATES + 1) / 2;
+        return h;
+    }
+
+    // 先写同目录下的临时文件并落盘，再 rename 覆盖目标：其他进程可能正映射着旧文件，
+    // 原地截断重写会让它们读到半截数据或收到 SIGBUS；rename 后它们仍映射旧的 inode，之后打开的才看到新表
+    bool save(const string &path) const
+    {
+        DistanceTableHeader h = make_header(goal);
+        h.checksum = checksum(nib, h.data_bytes);
+#ifndef _WIN32
+        string tmp = path + ".tmp." + to_string(getpid());
+#else
+        string tmp = path + ".tmp";
+#endif
+        FILE *fp = fopen(tmp.c_str(), "wb");
+        if (!fp)
+            return false;
+        bool ok = fwrite(&h, sizeof h, 1, fp) == 1 && fwrite(nib, 1, h.data_bytes, fp) == h.data_bytes;
+        ok = fflush(fp) == 0 && ok;
+#ifndef _WIN32
+        ok = fsync(fileno(fp)) == 0 && ok;
+#endif
+        ok = fclose(fp) == 0 && ok;
+#ifdef _WIN32
+        if (ok)
+            remove(path.c_str()); // Windows 的 rename 不覆盖已有文件
+#endif
+        if (!ok || rename(tmp.c_str(), path.c_str()) != 0)
+        {
+            remove(tmp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // 只读映射距离表文件；文件头与目标、格式不符或数据校验和不符时返回NULL。
+    // 数据只有 9!/2 字节，每次打开都校验，损坏的表不会被当作正确的使用
+    static DistanceTable *open(const string &path, const Board &goal)
+    {
+        DistanceTableHeader want = make_header(goal), h;
+        unique_ptr<DistanceTable> t(new DistanceTable(goal, 0));
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return NULL;
+        struct stat st;
+        size_t len = fstat(fd, &st) == 0 ? (size_t)st.st_size : 0;
+        if (len < sizeof h)
+        {
+            close(fd);
+            return NULL;
+        }
+        void *p = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED)
+            return NULL;
+        t->mapped = p, t->mapped_len = len;
+        const uint8_t *base = (const uint8_t *)p;
+#else
+        FILE *fp = fopen(path.c_str(), "rb");
+        if (!fp)
+            return NULL;
+        t->own.resize(sizeof h + want.data_bytes);
+        size_t len = fread(t->own.data(), 1, t->own.size(), fp);
+        fclose(fp);
+        const uint8_t *base = t->own.data();
+#endif
+        memcpy(&h, base, sizeof h);
+        h.checksum = 0;
+        if (memcmp(&h, &want, sizeof h) != 0 || len < sizeof h + h.data_bytes)
+            return NULL;
+        t->nib = base + sizeof h;
+        if (checksum(t->nib, h.data_bytes) != ((const DistanceTableHeader *)base)->checksum)
+            return NULL;
+        return t.release();
+    }
+
+private:
+    vector<uint8_t> own;
+    const uint8_t *nib;
+    void *mapped;
+    size_t mapped_len;
+
+    DistanceTable(const Board &goal, int) : goal(goal), nib(NULL), mapped(NULL), mapped_len(0) {}
+
+    void set(uint32_t r, int d)
+    {
+        uint8_t *p = own.data();
+        p[r >> 1] = (uint8_t)((p[r >> 1] & ~(15 << (4 * (r & 1)))) | (d << (4 * (r & 1))));
+    }
+};
+
+// ---------------- 目标重编号 ----------------
+// 对任意目标，先用棋盘的8种旋转/翻转之一把目标的空格移到代表格（角0、边1、中心4），
+// 再把数字重新编号，使目标变成该类的规范目标。这是状态图的同构，距离和路径一一对应，
+// 所以同一张规范目标的距离表（最多3张）可以回答任意目标的查询。
+struct GoalMap
+{
+    int cell[9];  // 原棋盘第i格 → 规范棋盘的格
+    int label[9]; // 原数字 → 规范数字（空格0映射到0）
+    Board canon;  // 规范目标
+
+    // 空格在代表格 0/1/4 时的规范目标
+    static Board canonical_goal(int z)
+    {
+        return z == 4 ? Board("1238_4765") : z == 0 ? Board("_12345678") : Board("1_2345678");
+    }
+
+    // 第t种变换下第i格的去向：t&4 转置，t&2 上下翻转，t&1 左右翻转
+    static int transform(int t, int i)
+    {
+        int r = i / 3, c = i % 3;
+        if (t & 4)
+            swap(r, c);
+        if (t & 2)
+            r = 2 - r;
+        if (t & 1)
+            c = 2 - c;
+        return r * 3 + c;
+    }
+
+    GoalMap(const Board &goal)
+    {
+        int t = 0;
+        while (transform(t, goal.z) != 0 && transform(t, goal.z) != 1 && transform(t, goal.z) != 4)
+            t++;
+        for (int i = 0; i < 9; i++)
+            cell[i] = transform(t, i);
+        canon = canonical_goal(cell[goal.z]);
+        for (int i = 0; i < 9; i++)
+            label[goal.tile(i)] = canon.tile(cell[i]);
+    }
+
+    Board to_canon(const Board &b) const
+    {
+        Board m;
+        m.v = 0;
+        for (int i = 0; i < 9; i++)
+            m.v |= (uint64_t)label[b.tile(i)] << (4 * cell[i]);
+        m.z = cell[b.z];
+        return m;
+    }
+
+    Board from_canon(const Board &m) const
+    {
+        int unlabel[9];
+        for (int t = 0; t < 9; t++)
+            unlabel[label[t]] = t;
+        Board b;
+        b.v = 0;
+        for (int i = 0; i < 9; i++)
+        {
+            b.v |= (uint64_t)unlabel[m.tile(cell[i])] << (4 * i);
+            if (cell[i] == m.z)
+                b.z = i;
+        }
+        return b;
+    }
+
+    // 用规范目标的距离表求原目标下的最优路径
+    vector<Board> path(const DistanceTable &table, const Board &start) const
+    {
+        vector<Board> seq = table.path(to_canon(start));
+        for (Board &b : seq)
+            b = from_canon(b);
+        return seq;
+    }
+};
+
+// ---------------- 并行逐层BFS ----------------
+// 每层的状态分成小块，由各线程取块扩展，新状态放进线程自己的下一层缓冲区，整层结束后拼成新的一层。
+// 去重用按编号索引的原子位图（fetch_or 的旧值决定谁先到），到达方向存在共享的每状态2位数组里。
+
+// 原子位图，insert 在该位原来为0时返回true
+struct AtomicBits
+{
+    unique_ptr<atomic<uint64_t>[]> w;
+    AtomicBits(size_t n) : w(new atomic<uint64_t>[(n + 63) / 64])
+    {
+        for (size_t i = 0; i < (n + 63) / 64; i++)
+            w[i].store(0, memory_order_relaxed);
+    }
+    bool test(size_t i) const { return (w[i >> 6].load(memory_order_relaxed) >> (i & 63)) & 1; }
+    bool insert(size_t i)
+    {
+        uint64_t m = 1ULL << (i & 63);
+        return !(w[i >> 6].fetch_or(m, memory_order_relaxed) & m);
+    }
+};
+
+// 原子的每状态2位移动方向数组。每个状态只由抢到访问位的线程写一次，初值为0，所以或进去即可
+struct AtomicMoveArray
+{
+    unique_ptr<atomic<uint64_t>[]> w;
+    AtomicMoveArray(size_t n) : w(new atomic<uint64_t>[(n + 31) / 32])
+    {
+        for (size_t i = 0; i < (n + 31) / 32; i++)
+            w[i].store(0, memory_order_relaxed);
+    }
+    int get(size_t i) const { return (int)(w[i >> 5].load(memory_order_relaxed) >> (2 * (i & 31))) & 3; }
+    void set(size_t i, int k) { w[i >> 5].fetch_or((uint64_t)k << (2 * (i & 31)), memory_order_relaxed); }
+};
+
+// 空格加一组数字的位置构成的状态空间，其余数字不区分。
+// 编号沿用 PatternDB 的部分排列编号（把空格当作第0个数字），跟踪全部数字时就是完整状态空间。
+template <int R, int C>
+struct PartialSpace
+{
+    typedef BoardT<R, C> B;
+    static constexpr int N = B::N;
+    PatternDB<R, C> idx; // 只用它的编号，不建表
+    int k;               // 跟踪的位置数（含空格）
+
+    PartialSpace(const vector<int> &tiles, const B &goal)
+    {
+        vector<int> t(1, 0);
+        t.insert(t.end(), tiles.begin(), tiles.end());
+        idx = PatternDB<R, C>(t, goal);
+        k = (int)t.size();
+    }
+    size_t size() const { return idx.size(); }
+    uint32_t root() const { return (uint32_t)idx.rank(idx.goalpos.data()); }
+
+    uint32_t rank(const B &b) const
+    {
+        int where[N], pos[N];
+        for (int i = 0; i < N; i++)
+            where[b.tile(i)] = i;
+        for (int i = 0; i < k; i++)
+            pos[i] = where[idx.tiles[i]];
+        return (uint32_t)idx.rank(pos);
+    }
+
+    // 跟踪全部数字时还原棋盘
+    B board(uint32_t r) const
+    {
+        int pos[N];
+        idx.unrank(r, pos);
+        B b;
+        b.v = 0;
+        b.z = pos[0];
+        for (int i = 1; i < k; i++)
+            b.v |= (typename B::word_t)idx.tiles[i] << (B::BITS * pos[i]);
+        return b;
+    }
+
+    // 空格朝方向m移动后的编号，出界时返回-1
+    int64_t step(uint32_t r, int m) const
+    {
+        int pos[N];
+        idx.unrank(r, pos);
+        return step(pos, m);
+    }
+
+    // 对r的每个后继调用 fn(编号, 方向)
+    template <class F>
+    void expand(uint32_t r, F fn) const
+    {
+        int pos[N];
+        idx.unrank(r, pos);
+        for (int m = 0; m < 4; m++)
+        {
+            int64_t c = step(pos, m);
+            if (c >= 0)
+                fn((uint32_t)c, m);
+        }
+    }
+
+private:
+    int64_t step(int *pos, int m) const
+    {
+        static const int dr[4] = {-1, 1, 0, 0}, dc[4] = {0, 0, -1, 1};
+        int z = pos[0], nr = z / C + dr[m], nc = z % C + dc[m];
+        if (nr < 0 || nr >= R || nc < 0 || nc >= C)
+            return -1;
+        int nz = nr * C + nc, j = 1;
+        while (j < k && pos[j] != nz)
+            j++;
+        pos[0] = nz;
+        if (j < k)
+            pos[j] = z;
+        int64_t c = (int64_t)idx.rank(pos);
+        pos[0] = z;
+        if (j < k)
+            pos[j] = nz;
+        return c;
+    }
+};
+
+// Space 需要提供 size()、expand(r, fn)、step(r, m)，编号必须放得进32位
+template <class Space>
+struct ParallelBfs
+{
+    const Space &sp;
+    int threads;
+    AtomicBits vis;
+    AtomicMoveArray parent;  // 到达每个状态时空格移动的方向
+    vector<uint64_t> layers; // 每层的状态数
+    uint32_t root = 0;
+
+    ParallelBfs(const Space &sp, int threads = 0)
+        : sp(sp), threads(threads > 0 ? threads : max(1u, thread::hardware_concurrency())),
+          vis(sp.size()), parent(sp.size()) {}
+
+    // 从 root 逐层扩展，直到空间穷尽、深度达到 max_depth（<0不限）或 stop 被访问。
+    // 返回扩展（出队）的状态数
+    uint64_t run(uint32_t root_, int max_depth = -1, int64_t stop = -1)
+    {
+        const size_t CHUNK = 4096;
+        root = root_;
+        vector<uint32_t> cur(1, root);
+        vis.insert(root);
+        layers.assign(1, 1);
+        uint64_t expanded = 0;
+        vector<vector<uint32_t>> next(threads);
+        for (int d = 0; !cur.empty() && d != max_depth && !(stop >= 0 && vis.test(stop)); d++)
+        {
+            atomic<size_t> cursor(0);
+            auto work = [&](int t)
+            {
+                vector<uint32_t> &out = next[t];
+                for (size_t lo; (lo = cursor.fetch_add(CHUNK)) < cur.size();)
+                    for (size_t i = lo; i < min(lo + CHUNK, cur.size()); i++)
+                        sp.expand(cur[i], [&](uint32_t c, int m)
+                                  {
+                            if (vis.insert(c))
+                            {
+                                parent.set(c, m);
+                                out.push_back(c);
+                            } });
+            };
+            if (cur.size() <= CHUNK || threads == 1)
+                work(0);
+            else
+            {
+                vector<thread> pool;
+                for (int t = 1; t < threads; t++)
+                    pool.emplace_back(work, t);
+                work(0);
+                for (thread &th : pool)
+                    th.join();
+            }
+            expanded += cur.size();
+            size_t total = 0;
+            for (int t = 0; t < threads; t++)
+                total += next[t].size();
+            vector<uint32_t>().swap(cur);
+            cur.reserve(total);
+            for (int t = 0; t < threads; t++)
+            {
+                cur.insert(cur.end(), next[t].begin(), next[t].end());
+                vector<uint32_t>().swap(next[t]);
+            }
+            if (!cur.empty())
+                layers.push_back(cur.size());
+        }
+        return expanded;
+    }
+
+    // 从 r 沿到达方向反着走回 root，返回 root..r 的编号序列
+    vector<uint32_t> path(uint32_t r) const
+    {
+        vector<uint32_t> seq(1, r);
+        while (r != root)
+        {
+            r = (uint32_t)sp.step(r, parent.get(r) ^ 1);
+            seq.push_back(r);
+        }
+        reverse(seq.begin(), seq.end());
+        return seq;
+    }
+};
+
+// ---------------- 外存BFS（延迟重复检测） ----------------
+// 每层状态按压缩整数排好序、去重后存成一个文件。扩展第d层时顺序读入，子状态攒满内存缓冲区就排序去重写成一个run文件；
+// 整层扩展完后把所有run多路归并，同时与第d层、第d-1层的文件流式比对，去掉已出现过的状态，写出第d+1层。
+// run 文件多于 EBFS_FAN_IN 个时先分组归并成中间run，所以同时打开的文件和读缓冲都不超过 EBFS_FAN_IN+3 个；
+// 内存只有扩展缓冲区加上这些读写缓冲，磁盘上只保留最近三层，读写全部是大块顺序操作。
+// 状态用棋盘的压缩整数表示（空格位置由值为0的格推出），因此只支持16格以内的棋盘。
+
+// 有序 uint64 文件的顺序读。path 为空表示空序列；文件打不开或读出错时 bad 为true，不能当作空序列
+struct RunReader
+{
+    FILE *fp = NULL;
+    vector<uint64_t> buf;
+    size_t pos = 0, len = 0;
+    uint64_t cur = 0; // 当前值，valid 为false时无意义
+    bool valid = false, bad = false;
+
+    RunReader(const string &path, size_t block)
+    {
+        if (!path.empty() && !(fp = fopen(path.c_str(), "rb")))
+            bad = true;
+        buf.resize(block);
+        next();
+    }
+    ~RunReader()
+    {
+        if (fp)
+            fclose(fp);
+    }
+    bool next()
+    {
+        if (pos == len)
+        {
+            len = fp ? fread(buf.data(), sizeof(uint64_t), buf.size(), fp) : 0;
+            pos = 0;
+            if (fp && ferror(fp))
+                bad = true;
+        }
+        valid = pos < len;
+        if (valid)
+            cur = buf[pos++];
+        return valid;
+    }
+};
+
+// uint64 文件的顺序写
+struct RunWriter
+{
+    FILE *fp;
+    vector<uint64_t> buf;
+    uint64_t count = 0;
+    bool ok;
+
+    RunWriter(const string &path, size_t block) : fp(fopen(path.c_str(), "wb")), ok(fp != NULL) { buf.reserve(block); }
+    ~RunWriter() { close(); }
+    void put(uint64_t x)
+    {
+        buf.push_back(x);
+        count++;
+        if (buf.size() == buf.capacity())
+            flush();
+    }
+    void flush()
+    {
+        if (fp && !buf.empty() && fwrite(buf.data(), sizeof(uint64_t), buf.size(), fp) != buf.size())
+            ok = false;
+        buf.clear();
+    }
+    bool close()
+    {
+        if (fp)
+        {
+            flush();
+            if (fclose(fp) != 0)
+                ok = false;
+            fp = NULL;
+        }
+        return ok;
+    }
+};
+
+#define EBFS_FAN_IN 16 // 一次归并的run文件数上限
+
+template <int R, int C>
+struct ExternalBfs
+{
+    typedef BoardT<R, C> B;
+    static_assert(B::N <= 16, "外存BFS的状态必须放得进64位");
+
+    string prefix;           // 层文件和run文件的路径前缀
+    size_t mem_states;       // 扩展缓冲区能放的状态数
+    size_t block;            // 每个文件读写缓冲的状态数
+    vector<uint64_t> layers; // 每层的状态数
+
+    ExternalBfs(const string &prefix, size_t mem_bytes, size_t block_bytes = 1 << 20)
+        : prefix(prefix), mem_states(max<size_t>(mem_bytes / sizeof(uint64_t), 1024)),
+          block(max<size_t>(block_bytes / sizeof(uint64_t), 512)) {}
+
+    string level_path(int d) const { return prefix + ".level." + to_string(d); }
+
+    static B board(uint64_t v)
+    {
+        B b;
+        b.v = v;
+        b.z = 0;
+        while (b.tile(b.z) != 0)
+            b.z++;
+        return b;
+    }
+
+    // 从 root 逐层扩展，直到空间穷尽或深度达到 max_depth（<0不限）。
+    // 返回最后一层的深度，文件出错时返回-1；最后一层文件保留在 level_path(深度)，供调用者读取
+    int run(const B &root, int max_depth = -1)
+    {
+        {
+            RunWriter w(level_path(0), block);
+            w.put((uint64_t)root.v);
+            if (!w.close())
+            {
+                remove(level_path(0).c_str());
+                return -1;
+            }
+        }
+        layers.assign(1, 1);
+        int d = 0;
+        for (; d != max_depth; d++)
+        {
+            uint64_t n = expand(d);
+            if (n == (uint64_t)-1)
+            {
+                // 出错时删掉所有还留着的层文件（run文件已由 expand 删除）
+                for (int i = max(d - 1, 0); i <= d + 1; i++)
+                    remove(level_path(i).c_str());
+                return -1;
+            }
+            if (n == 0)
+            {
+                remove(level_path(d + 1).c_str());
+                break;
+            }
+            layers.push_back(n);
+            if (d >= 1)
+                remove(level_path(d - 1).c_str());
+        }
+        if (d >= 1)
+            remove(level_path(d - 1).c_str());
+        return d;
+    }
+
+    // 读出某层文件中的全部状态（只用于最后一层这样不大的文件）
+    template <class F>
+    void each(int d, F fn) const
+    {
+        RunReader r(level_path(d), block);
+        for (; r.valid; r.next())
+            fn(board(r.cur));
+    }
+
+private:
+    int run_id = 0; // 本次搜索中run文件的编号
+
+    string new_run() { return prefix + ".run." + to_string(run_id++); }
+
+    // 把有序的 in 归并去重写到 out；filter 时再去掉在第d、d-1层出现过的状态。返回写出的状态数，出错时返回-1
+    uint64_t merge(const vector<string> &in, const string &out_path, bool filter, int d)
+    {
+        vector<unique_ptr<RunReader>> r;
+        for (const string &p : in)
+            r.emplace_back(new RunReader(p, block));
+        RunReader prev0(filter ? level_path(d) : string(), block);
+        RunReader prev1(filter && d > 0 ? level_path(d - 1) : string(), block);
+        typedef pair<uint64_t, int> item_t;
+        priority_queue<item_t, vector<item_t>, greater<item_t>> heap;
+        for (int i = 0; i < (int)r.size(); i++)
+            if (r[i]->valid)
+                heap.push({r[i]->cur, i});
+        RunWriter out(out_path, block);
+        bool has_last = false;
+        uint64_t last = 0;
+        while (!heap.empty())
+        {
+            item_t top = heap.top();
+            heap.pop();
+            if (r[top.second]->next())
+                heap.push({r[top.second]->cur, top.second});
+            uint64_t x = top.first;
+            if (has_last && x == last)
+                continue;
+            has_last = true;
+            last = x;
+            while (prev0.valid && prev0.cur < x)
+                prev0.next();
+            while (prev1.valid && prev1.cur < x)
+                prev1.next();
+            if ((prev0.valid && prev0.cur == x) || (prev1.valid && prev1.cur == x))
+                continue;
+            out.put(x);
+        }
+        bool ok = out.close() && !prev0.bad && !prev1.bad;
+        for (auto &x : r)
+            ok = ok && !x->bad;
+        return ok ? out.count : (uint64_t)-1;
+    }
+
+    // 由第d层生成第d+1层，返回新层的状态数，出错时返回-1（此时已删除本层产生的run文件）
+    uint64_t expand(int d)
+    {
+        vector<string> runs;
+        vector<uint64_t> buf;
+        buf.reserve(mem_states);
+        bool ok = true;
+        auto cleanup = [&]()
+        {
+            for (const string &p : runs)
+                remove(p.c_str());
+        };
+        auto spill = [&]()
+        {
+            sort(buf.begin(), buf.end());
+            buf.erase(unique(buf.begin(), buf.end()), buf.end());
+            runs.push_back(new_run());
+            RunWriter w(runs.back(), block);
+            for (uint64_t x : buf)
+                w.put(x);
+            ok = w.close() && ok;
+            buf.clear();
+        };
+        {
+            RunReader in(level_path(d), block);
+            for (; in.valid && ok; in.next())
+            {
+                B b = board(in.cur);
+                for (int k = 0; k < 4; k++)
+                {
+                    int nz = b.target(k);
+                    if (nz < 0)
+                        continue;
+                    buf.push_back((uint64_t)b.moved(nz).v);
+                    if (buf.size() == mem_states)
+                        spill();
+                }
+            }
+            ok = ok && !in.bad;
+        }
+        if (ok && !buf.empty())
+            spill();
+        vector<uint64_t>().swap(buf);
+        if (!ok)
+        {
+            cleanup();
+            return (uint64_t)-1;
+        }
+
+        // run 太多时分组归并，直到剩下的能一次归并完
+        while (runs.size() > EBFS_FAN_IN)
+        {
+            vector<string> next;
+            for (size_t i = 0; i < runs.size() && ok; i += EBFS_FAN_IN)
+            {
+                vector<string> group(runs.begin() + i, runs.begin() + min(i + EBFS_FAN_IN, runs.size()));
+                next.push_back(new_run());
+                ok = merge(group, next.back(), false, d) != (uint64_t)-1;
+                for (const string &p : group)
+                    remove(p.c_str());
+            }
+            if (!ok)
+            {
+                runs.insert(runs.end(), next.begin(), next.end());
+                cleanup();
+                return (uint64_t)-1;
+            }
+            runs.swap(next);
+        }
+
+        // 最后一次归并时去掉在第d、d-1层出现过的状态，写出第d+1层
+        uint64_t n = merge(runs, level_path(d + 1), true, d);
+        cleanup();
+        return n;
+    }
+};
+
+// ---------------- 前沿搜索（Korf） ----------------
+// 逐层BFS但不保留已访问集合：每个状态带4位“已用方向”，记下哪些方向通向生成它的上一层状态。
+// 扩展时跳过这些方向，同一层里重复生成的状态把位或在一起。滑块拼图的状态图是二部图，
+// 一个状态的邻居只在上一层或下一层，上一层的邻居都已生成过它并置了对应的位，所以不会走回头路，
+// 内存只有相邻两层。路径不能沿父指针回溯，改用分治：再搜一次，让每个状态带上它在中间层的祖先，
+// 到达目标时就得到最短路径上的中点，然后对前后两半递归。状态用压缩整数表示，只支持16格以内的棋盘。
+template <int R, int C>
+struct FrontierSearch
+{
+    typedef BoardT<R, C> B;
+    static_assert(B::N <= 16, "前沿搜索的状态必须放得进64位");
+
+    struct Node
+    {
+        uint8_t used; // 已用方向（通向上一层）
+        int8_t z;
+        uint64_t mid; // 中间层的祖先
+    };
+
+    long long expanded = 0; // 所有轮次扩展的状态数
+    size_t peak = 0;        // 同时保存的最多状态数（相邻两层之和）
+
+    // 返回最短路径（含起点），不可达时返回空
+    vector<B> solve(const B &start, const B &goal)
+    {
+        int d = search(start, goal, -1, NULL);
+        if (d < 0)
+            return vector<B>();
+        vector<B> path(1, start);
+        recover(start, goal, d, path);
+        return path;
+    }
+
+    // 从 start 逐层搜到 goal，返回步数，空间穷尽时返回-1。
+    // mid 非空时在其中返回最短路径上第 mid_depth 步的状态
+    int search(const B &start, const B &goal, int mid_depth, B *mid)
+    {
+        unordered_map<uint64_t, Node, BoardHash> cur, next;
+        cur[start.v] = Node{0, (int8_t)start.z, start.v};
+        for (int d = 0; !cur.empty(); d++)
+        {
+            auto it = cur.find(goal.v);
+            if (it != cur.end())
+            {
+                if (mid)
+                {
+                    mid->v = it->second.mid;
+                    for (mid->z = 0; mid->tile(mid->z) != 0; mid->z++)
+                        ;
+                }
+                return d;
+            }
+            if (d == mid_depth)
+                for (auto &e : cur)
+                    e.second.mid = e.first;
+            next.clear();
+            for (const auto &e : cur)
+            {
+                expanded++;
+                B b;
+                b.v = e.first;
+                b.z = e.second.z;
+                for (int k = 0; k < 4; k++)
+                {
+                    int nz = b.target(k);
+                    if (nz < 0 || (e.second.used >> k & 1))
+                        continue;
+                    B c = b.moved(nz);
+                    auto r = next.try_emplace((uint64_t)c.v, Node{0, (int8_t)nz, e.second.mid});
+                    r.first->second.used |= 1 << (k ^ 1);
+                }
+            }
+            peak = max(peak, cur.size() + next.size());
+            swap(cur, next);
+        }
+        return -1;
+    }
+
+private:
+    // 已知 s 到 g 恰好 d 步，把 s 之后的路径接到 path 上
+    void recover(const B &s, const B &g, int d, vector<B> &path)
+    {
+        if (d == 0)
+            return;
+        if (d == 1)
+        {
+            path.push_back(g);
+            return;
+        }
+        B m;
+        search(s, g, d / 2, &m);
+        recover(s, m, d / 2, path);
+        recover(m, g, d - d / 2, path);
+    }
+};
@@ -0,0 +1,961 @@
+#pragma once
+// N皇后公共位运算引擎
+// 用机器字记录已占用的列和两条对角线，空位 = ~(cols|ld|rd)，再逐个取最低位
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#ifdef _WIN32
+#include <io.h>
+#define queens_ftruncate(fd, len) _chsize(fd, len)
+#else
+#include <unistd.h>
+#define queens_ftruncate(fd, len) ftruncate(fd, len)
+#endif
+
+#define QUEENS_MAX_N 32
+
+typedef uint32_t qmask_t; // 第i位表示第i列
+
+// 定义 QUEENS_STATS 后各搜索函数统计扩展的节点数（基准测试用），否则不产生任何开销。
+// 每个线程先累加到自己的 queens_nodes，工作窃取线程退出前并入 queens_nodes_total
+#ifdef QUEENS_STATS
+inline std::atomic<long long> queens_nodes_total{0};
+inline thread_local long long queens_nodes = 0;
+#define QUEENS_NODE() (queens_nodes++)
+#else
+#define QUEENS_NODE() ((void)0)
+#endif
+
+// n列全部可用时的掩码
+inline qmask_t queens_full(int n)
+{
+    return n >= 32 ? ~(qmask_t)0 : (((qmask_t)1 << n) - 1);
+}
+
+// 最低位1所在的列号
+inline int queens_col(qmask_t bit)
+{
+    return __builtin_ctz(bit);
+}
+
+// 在当前行放一个皇后后，计算下一行的 (cols, ld, rd)
+// ld: 向列号增大方向延伸的对角线，rd: 向列号减小方向延伸的对角线
+inline void queens_place(qmask_t full, qmask_t bit, qmask_t &cols, qmask_t &ld, qmask_t &rd)
+{
+    cols |= bit;
+    ld = ((ld | bit) << 1) & full;
+    rd = (rd | bit) >> 1;
+}
+
+// 深度优先计数：从当前行的 (cols, ld, rd) 出发，返回解数；cols填满即得到一个解
+inline long long queens_dfs(qmask_t full, qmask_t cols, qmask_t ld, qmask_t rd)
+{
+    QUEENS_NODE();
+    if (cols == full)
+        return 1;
+    long long cnt = 0;
+    qmask_t avail = ~(cols | ld | rd) & full;
+    while (avail)
+    {
+        qmask_t bit = avail & (0 - avail);
+        avail ^= bit;
+        cnt += queens_dfs(full, cols | bit, ((ld | bit) << 1) & full, (rd | bit) >> 1);
+    }
+    return cnt;
+}
+
+// n皇后解的总数（1 <= n <= QUEENS_MAX_N）
+inline long long queens_count(int n)
+{
+    if (n < 1 || n > QUEENS_MAX_N)
+        return 0;
+    return queens_dfs(queens_full(n), 0, 0, 0);
+}
+
+// ---------------- 多线程工作窃取 ----------------
+// 每个线程一个双端队列：自己从队尾取（后进先出，局部性好），空闲时从别人的队头偷（偷到的是较大的子树）
+
+template <class Task>
+class ws_pool_t
+{
+public:
+    explicit ws_pool_t(int threads) : qs(threads < 1 ? 1 : threads), pending(0), idle(0) {}
+
+    int threads() const { return (int)qs.size(); }
+
+    // 有线程在等任务时返回true，任务函数可据此把当前子树再拆开
+    bool hungry() const { return idle.load(std::memory_order_relaxed) > 0; }
+
+    // 把任务放到第self个线程的队尾
+    void push(int self, const Task &t)
+    {
+        pending.fetch_add(1);
+        std::lock_guard<std::mutex> lk(qs[self].mu);
+        qs[self].dq.push_back(t);
+    }
+
+    // fn(self, task) 返回该任务贡献的计数；各线程计数在结束时合并
+    template <class Fn>
+    long long run(const std::vector<Task> &init, Fn fn)
+    {
+        int T = threads();
+        for (int i = 0; i < (int)init.size(); i++)
+            push(i % T, init[i]);
+        std::vector<long long> part(T, 0);
+        std::vector<std::thread> th;
+        for (int w = 0; w < T; w++)
+            th.emplace_back([&, w]
+                            { part[w] = work(w, fn); });
+        for (auto &t : th)
+            t.join();
+        long long sum = 0;
+        for (long long c : part)
+            sum += c;
+        return sum;
+    }
+
+private:
+    struct queue_t
+    {
+        std::mutex mu;
+        std::deque<Task> dq;
+    };
+    std::vector<queue_t> qs;
+    std::atomic<long long> pending; // 已放入但尚未完成的任务数
+    std::atomic<int> idle;
+
+    bool pop(int self, Task &t)
+    {
+        {
+            std::lock_guard<std::mutex> lk(qs[self].mu);
+            if (!qs[self].dq.empty())
+            {
+                t = qs[self].dq.back();
+                qs[self].dq.pop_back();
+                return true;
+            }
+        }
+        int T = threads();
+        for (int k = 1; k < T; k++)
+        {
+            queue_t &v = qs[(self + k) % T];
+            std::lock_guard<std::mutex> lk(v.mu);
+            if (!v.dq.empty())
+            {
+                t = v.dq.front();
+                v.dq.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <class Fn>
+    long long work(int self, Fn &fn)
+    {
+        long long cnt = 0;
+        Task t;
+        while (true)
+        {
+            if (pop(self, t))
+            {
+                cnt += fn(self, t);
+                pending.fetch_sub(1);
+                continue;
+            }
+            if (pending.load() == 0)
+                break;
+            idle.fetch_add(1);
+            std::this_thread::yield();
+            idle.fetch_sub(1);
+        }
+#ifdef QUEENS_STATS
+        queens_nodes_total += queens_nodes;
+        queens_nodes = 0;
+#endif
+        return cnt;
+    }
+};
+
+// 并行计数用的子树：第row行之前已放好皇后
+typedef struct qtask_t
+{
+    int row;
+    qmask_t cols, ld, rd;
+} qtask_t;
+
+// 枚举前k行的所有合法摆法，作为初始任务
+inline void queens_split(int n, int k, qtask_t t, std::vector<qtask_t> &out)
+{
+    if (t.row == k || t.row == n)
+    {
+        out.push_back(t);
+        return;
+    }
+    qmask_t full = queens_full(n);
+    qmask_t avail = ~(t.cols | t.ld | t.rd) & full;
+    while (avail)
+    {
+        qmask_t bit = avail & (0 - avail);
+        avail ^= bit;
+        qtask_t c = t;
+        c.row++;
+        queens_place(full, bit, c.cols, c.ld, c.rd);
+        queens_split(n, k, c, out);
+    }
+}
+
+// 多线程计数：前split行拆成任务，线程空闲时剩余行数较多的子树会被再拆一层
+// threads <= 0 时使用全部核心
+inline long long queens_count_parallel(int n, int threads = 0, int split = 3)
+{
+    if (n < 1 || n > QUEENS_MAX_N)
+        return 0;
+    if (threads <= 0)
+        threads = (int)std::thread::hardware_concurrency();
+    qmask_t full = queens_full(n);
+    std::vector<qtask_t> init;
+    queens_split(n, split < n ? split : n, qtask_t{0, 0, 0, 0}, init);
+    ws_pool_t<qtask_t> pool(threads);
+    return pool.run(init, [&](int self, const qtask_t &t) -> long long
+                    {
+        if (pool.hungry() && n - t.row > 8)
+        {
+            qmask_t avail = ~(t.cols | t.ld | t.rd) & full;
+            while (avail)
+            {
+                qmask_t bit = avail & (0 - avail);
+                avail ^= bit;
+                qtask_t c = t;
+                c.row++;
+                queens_place(full, bit, c.cols, c.ld, c.rd);
+                pool.push(self, c);
+            }
+            return 0;
+        }
+        return queens_dfs(full, t.cols, t.ld, t.rd); });
+}
+
+// ---------------- 对称性约简计数 ----------------
+// 棋盘的8种旋转/翻转构成二面体群。只搜索第0行皇后在左半边（奇数n含中间列）的摆法，
+// 每个解检查它是否是所属轨道中字典序最小的代表；是则计入 unique，并按轨道大小 8/|稳定子| 累加总数。
+
+// q在8种变换下的像中与q相同的个数（即稳定子大小）；若某个像字典序更小则q不是代表，返回0
+inline int queens_stabilizer(int n, const int *q)
+{
+    int inv[QUEENS_MAX_N];
+    for (int r = 0; r < n; r++)
+        inv[q[r]] = r;
+    int same = 0;
+    for (int t = 0; t < 8; t++)
+    {
+        // t&4: 转置（取逆排列），t&2: 上下翻转，t&1: 左右翻转
+        const int *src = (t & 4) ? inv : q;
+        int cmp = 0;
+        for (int r = 0; r < n && cmp == 0; r++)
+        {
+            int v = src[(t & 2) ? n - 1 - r : r];
+            if (t & 1)
+                v = n - 1 - v;
+            cmp = v - q[r];
+        }
+        if (cmp < 0)
+            return 0;
+        if (cmp == 0)
+            same++;
+    }
+    return same;
+}
+
+template <class Fn>
+void queens_sym_dfs(int n, int row, qmask_t cols, qmask_t ld, qmask_t rd, int *q,
+                    Fn &on_unique, long long &total, long long &unique)
+{
+    QUEENS_NODE();
+    qmask_t full = queens_full(n);
+    if (row == n)
+    {
+        int same = queens_stabilizer(n, q);
+        if (same)
+        {
+            unique++;
+            total += 8 / same;
+            on_unique(q);
+        }
+        return;
+    }
+    qmask_t avail = ~(cols | ld | rd) & full;
+    if (row == 0)
+        avail &= ((qmask_t)1 << ((n + 1) / 2)) - 1; // 第0行只取左半边（含中间列）
+    else
+    {
+        // 代表解的首元素q[0]不大于任何像的首元素，所以另外三条边上的皇后离角至少q[0]格：
+        // 第0列、第n-1列的皇后只能在 [q0, n-1-q0] 行，第n-1行的皇后只能在 [q0, n-1-q0] 列
+        int q0 = q[0];
+        if (row < q0 || row > n - 1 - q0)
+            avail &= ~((qmask_t)1 | ((qmask_t)1 << (n - 1)));
+        if (row == n - 1)
+            avail &= queens_full(n - q0) & ~queens_full(q0);
+    }
+    while (avail)
+    {
+        qmask_t bit = avail & (0 - avail);
+        avail ^= bit;
+        q[row] = queens_col(bit);
+        queens_sym_dfs(n, row + 1, cols | bit, ((ld | bit) << 1) & full, (rd | bit) >> 1, q,
+                       on_unique, total, unique);
+    }
+}
+
+// 对称约简计数：返回解的总数，*unique 为本质不同的解数；每个本质不同的解（轨道代表）调用一次 on_unique(q)
+template <class Fn>
+long long queens_count_sym(int n, long long *unique, Fn on_unique)
+{
+    long long total = 0, uniq = 0;
+    if (n >= 1 && n <= QUEENS_MAX_N)
+    {
+        int q[QUEENS_MAX_N];
+        queens_sym_dfs(n, 0, 0, 0, 0, q, on_unique, total, uniq);
+    }
+    if (unique)
+        *unique = uniq;
+    return total;
+}
+
+inline long long queens_count_sym(int n, long long *unique)
+{
+    return queens_count_sym(n, unique, [](const int *) {});
+}
+
+// ---------------- 有界内存的逐层BFS ----------------
+// 同一层的状态放在一个缓冲区里，扩展到另一个缓冲区，处理完一层就交换两者并重复使用。
+// 每行皇后的列号用5位压缩存放；两个缓冲区合计超过内存上限时，剩余状态改为逐个DFS。
+
+typedef struct qpacked_t
+{
+    qmask_t cols, ld, rd;
+    uint64_t qp[(QUEENS_MAX_N * 5 + 63) / 64]; // 第r行的列号在第 5r..5r+4 位
+} qpacked_t;
+
+inline int qpacked_get(const qpacked_t &s, int row)
+{
+    int b = row * 5, w = b >> 6, o = b & 63;
+    uint64_t v = s.qp[w] >> o;
+    if (o > 59)
+        v |= s.qp[w + 1] << (64 - o);
+    return (int)(v & 31);
+}
+
+inline void qpacked_set(qpacked_t &s, int row, int col)
+{
+    int b = row * 5, w = b >> 6, o = b & 63;
+    s.qp[w] |= (uint64_t)col << o;
+    if (o > 59)
+        s.qp[w + 1] |= (uint64_t)col >> (64 - o);
+}
+
+// 从第row行开始DFS枚举，q[0..row-1]已填好；每个解调用 fn(q)
+template <class Fn>
+long long queens_enum_dfs(int n, int row, qmask_t cols, qmask_t ld, qmask_t rd, int *q, Fn &fn)
+{
+    QUEENS_NODE();
+    qmask_t full = queens_full(n);
+    if (row == n)
+    {
+        fn((const int *)q);
+        return 1;
+    }
+    long long cnt = 0;
+    qmask_t avail = ~(cols | ld | rd) & full;
+    while (avail)
+    {
+        qmask_t bit = avail & (0 - avail);
+        avail ^= bit;
+        q[row] = queens_col(bit);
+        cnt += queens_enum_dfs(n, row + 1, cols | bit, ((ld | bit) << 1) & full, (rd | bit) >> 1, q, fn);
+    }
+    return cnt;
+}
+
+// 逐层BFS枚举所有解，每个解调用 fn(q)；mem_bytes 为两个层缓冲区的总内存上限
+template <class Fn>
+long long queens_bfs(int n, size_t mem_bytes, Fn fn)
+{
+    if (n < 1 || n > QUEENS_MAX_N)
+        return 0;
+    qmask_t full = queens_full(n);
+    size_t cap = mem_bytes / sizeof(qpacked_t); // 两个缓冲区合计最多容纳的状态数
+    std::vector<qpacked_t> cur(1, qpacked_t{}), next;
+    long long cnt = 0;
+    int q[QUEENS_MAX_N];
+
+    for (int row = 0; row < n && !cur.empty(); row++)
+    {
+        next.clear();
+        size_t i = 0;
+        for (; i < cur.size(); i++)
+        {
+            const qpacked_t &s = cur[i];
+            QUEENS_NODE();
+            // 一个状态最多产生n个子状态；放不下又不能扩容时停止BFS
+            if (next.capacity() - next.size() < (size_t)n)
+            {
+                size_t grow = next.capacity() * 2 > 64 ? next.capacity() * 2 : 64;
+                if (cur.capacity() + grow > cap)
+                    break;
+                next.reserve(grow);
+            }
+            qmask_t avail = ~(s.cols | s.ld | s.rd) & full;
+            while (avail)
+            {
+                qmask_t bit = avail & (0 - avail);
+                avail ^= bit;
+                qpacked_t c = s;
+                c.cols |= bit;
+                c.ld = ((s.ld | bit) << 1) & full;
+                c.rd = (s.rd | bit) >> 1;
+                qpacked_set(c, row, queens_col(bit));
+                if (row + 1 == n)
+                {
+                    for (int r = 0; r < n; r++)
+                        q[r] = qpacked_get(c, r);
+                    fn((const int *)q);
+                    cnt++;
+                }
+                else
+                    next.push_back(c);
+            }
+        }
+        if (i < cur.size())
+        {
+            // 超出内存上限：已生成的下一层和本层未扩展的状态全部改用DFS
+            for (const qpacked_t &s : next)
+            {
+                for (int r = 0; r <= row; r++)
+                    q[r] = qpacked_get(s, r);
+                cnt += queens_enum_dfs(n, row + 1, s.cols, s.ld, s.rd, q, fn);
+            }
+            for (; i < cur.size(); i++)
+            {
+                const qpacked_t &s = cur[i];
+                for (int r = 0; r < row; r++)
+                    q[r] = qpacked_get(s, r);
+                cnt += queens_enum_dfs(n, row, s.cols, s.ld, s.rd, q, fn);
+            }
+            return cnt;
+        }
+        cur.swap(next);
+    }
+    return cnt;
+}
+
+// ---------------- 解的缓冲输出 ----------------
+// 攒满一大块再一次性 fwrite，避免每个解一次 printf。写失败会被记下，调用者用 finish() 检查后再 fclose。
+// QW_BINARY: 每个解n字节，第r字节为第r行皇后的列号，可直接 mmap 成定长记录
+// QW_TEXT:   每个解一行，第r个字符为第r行的列号（0-9a-v，32进制）
+
+enum qwrite_fmt_t
+{
+    QW_BINARY,
+    QW_TEXT
+};
+
+class qwriter_t
+{
+public:
+    qwriter_t(FILE *fp, qwrite_fmt_t fmt, size_t buf_bytes = 1 << 20)
+        : fp(fp), fmt(fmt), buf(buf_bytes < 64 ? 64 : buf_bytes), len(0), failed(false) {}
+    ~qwriter_t() { flush(); }
+
+    void put(int n, const int *q)
+    {
+        if (len + n + 1 > buf.size())
+            flush();
+        for (int r = 0; r < n; r++)
+            buf[len++] = fmt == QW_BINARY ? (char)q[r] : "0123456789abcdefghijklmnopqrstuv"[q[r]];
+        if (fmt == QW_TEXT)
+            buf[len++] = '\n';
+    }
+
+    void flush()
+    {
+        if (len && fwrite(buf.data(), 1, len, fp) != len)
+            failed = true;
+        len = 0;
+    }
+
+    // 写出剩余缓冲并冲洗文件流；之前任何一次写失败都返回false
+    bool finish()
+    {
+        flush();
+        if (fflush(fp) != 0)
+            failed = true;
+        return !failed;
+    }
+
+private:
+    FILE *fp;
+    qwrite_fmt_t fmt;
+    std::vector<char> buf;
+    size_t len;
+    bool failed;
+};
+
+// ---------------- 最小冲突局部搜索（求一个解，N可到10^6） ----------------
+// q始终是一个排列，所以每列恰好一个皇后；只需维护两组对角线计数器，内存 O(N)。
+// 初始：逐行贪心地从剩余列中随机挑选不在已占对角线上的列；挑不到就先随便放。
+// 修复：对仍有冲突的行随机选另一行交换两者的列，只接受不增加冲突数的交换；卡住时换随机种子重来。
+
+class qlocal_t
+{
+public:
+    qlocal_t(int n, uint64_t seed) : n(n), rng(seed), dp(2 * n), dn(2 * n), q(n), total(0) {}
+
+    // 成功时返回true，*steps 累计尝试交换的次数
+    bool solve(std::vector<int> &out, long long max_steps, long long *steps)
+    {
+        greedy_init();
+        std::vector<int> bad;
+        long long tries = 0, best = total;
+        int stall = 0; // 连续没有降低冲突数的轮数
+        while (total > 0 && tries < max_steps && stall < 20)
+        {
+            bad.clear();
+            for (int r = 0; r < n; r++)
+                if (attacked(r))
+                    bad.push_back(r);
+            for (int r : bad)
+            {
+                // 每个冲突行最多尝试若干次交换
+                for (int k = 0; k < 64 && attacked(r); k++, tries++)
+                    try_swap(r, (int)(rng() % n));
+            }
+            if (total < best)
+                best = total, stall = 0;
+            else
+                stall++;
+        }
+        if (steps)
+            *steps += tries;
+        if (total > 0)
+            return false;
+        out = q;
+        return true;
+    }
+
+private:
+    int n;
+    std::mt19937_64 rng;
+    std::vector<int> dp, dn; // dp[r+c], dn[r-c+n-1]：每条对角线上的皇后数
+    std::vector<int> q;
+    long long total; // 冲突数：各对角线上 (皇后数-1) 之和
+
+    int &pos(int r, int c) { return dp[r + c]; }
+    int &neg(int r, int c) { return dn[r - c + n - 1]; }
+    bool attacked(int r) { return pos(r, q[r]) > 1 || neg(r, q[r]) > 1; }
+
+    void add(int r, int c)
+    {
+        total += (pos(r, c)++ > 0) + (neg(r, c)++ > 0);
+    }
+    void remove(int r, int c)
+    {
+        total -= (--pos(r, c) > 0) + (--neg(r, c) > 0);
+    }
+
+    // 交换第a、b两行的列，冲突数变多就撤销（持平也接受，便于走出平台）
+    void try_swap(int a, int b)
+    {
+        if (a == b)
+            return;
+        long long before = total;
+        remove(a, q[a]);
+        remove(b, q[b]);
+        add(a, q[b]);
+        add(b, q[a]);
+        if (total <= before)
+        {
+            std::swap(q[a], q[b]);
+            return;
+        }
+        remove(a, q[b]);
+        remove(b, q[a]);
+        add(a, q[a]);
+        add(b, q[b]);
+    }
+
+    void greedy_init()
+    {
+        std::fill(dp.begin(), dp.end(), 0);
+        std::fill(dn.begin(), dn.end(), 0);
+        total = 0;
+        for (int i = 0; i < n; i++)
+            q[i] = i;
+        for (int i = 0; i < n; i++)
+        {
+            // q[i..n-1] 是尚未使用的列，随机挑一个对角线空闲的换到第i行
+            int j = i + (int)(rng() % (n - i));
+            for (int k = 0; k < 32 && (pos(i, q[j]) || neg(i, q[j])); k++)
+                j = i + (int)(rng() % (n - i));
+            std::swap(q[i], q[j]);
+            add(i, q[i]);
+        }
+    }
+};
+
+// 用最小冲突局部搜索求一个n皇后解，q[r]为第r行的列号；n=2、3无解时返回false
+inline bool queens_min_conflicts(int n, std::vector<int> &q, uint64_t seed = 1, long long *steps = NULL)
+{
+    if (n < 1 || n == 2 || n == 3)
+        return false;
+    for (int restart = 0; restart < 100; restart++)
+    {
+        qlocal_t ls(n, seed + restart);
+        if (ls.solve(q, 20LL * n + 100000, steps))
+            return true;
+    }
+    return false;
+}
+
+// ---------------- 断点续算 ----------------
+// 前k行的所有合法摆法按生成顺序编号为任务0..T-1，每个任务独立计数。
+// 断点文件是文本：第一行 "queens n k T"，之后每行 "任务号 解数"，只追加不改写，
+// 被杀掉时最多丢失最后一个刷新周期内的结果；重启时跳过文件里已有的任务。
+// 不同进程可以各算一段任务号（各写各的文件），最后用 queens_merge 合并。
+
+// 上次被打断时最后一条记录可能只写了一半（如 "0 500" 只剩 "0 50"），补上换行会把它变成一条看似合法的错误记录，
+// 所以把文件截回最后一个完整的换行处；连表头都不完整时截成空文件，由调用者重新写表头
+inline bool queens_trim_checkpoint(const char *path)
+{
+    FILE *fp = fopen(path, "r+b");
+    if (!fp)
+        return true;
+    std::vector<char> buf;
+    char chunk[4096];
+    for (size_t got; (got = fread(chunk, 1, sizeof chunk, fp)) > 0;)
+        buf.insert(buf.end(), chunk, chunk + got);
+    size_t keep = buf.size();
+    while (keep && buf[keep - 1] != '\n')
+        keep--;
+    bool ok = true;
+    if (keep != buf.size())
+    {
+        fflush(fp);
+        ok = queens_ftruncate(fileno(fp), (long)keep) == 0;
+    }
+    fclose(fp);
+    return ok;
+}
+
+// 读取断点文件：头部与(n,k,T)不符时返回false；文件不存在视为空。
+// 没有以换行结尾的行是被打断的写入，直接丢弃
+inline bool queens_load_checkpoint(const char *path, int n, int k, int T, std::map<int, long long> &done)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+        return true;
+    char line[128];
+    int fn, fk, fT, id;
+    long long c;
+    if (!fgets(line, sizeof line, fp))
+    {
+        fclose(fp);
+        return true;
+    }
+    bool ok = sscanf(line, "queens %d %d %d", &fn, &fk, &fT) == 3 &&
+              fn == n && fk == k && fT == T;
+    while (ok && fgets(line, sizeof line, fp))
+    {
+        size_t len = strlen(line);
+        if (len && line[len - 1] == '\n' && sscanf(line, "%d %lld", &id, &c) == 2 && id >= 0 && id < T)
+            done[id] = c;
+    }
+    fclose(fp);
+    return ok;
+}
+
+// 计算任务号[first, last)并把结果写入断点文件，返回这段任务的解数之和；
+// 断点文件不匹配、或有结果没能写进断点文件时返回-1
+inline long long queens_count_checkpoint(int n, int k, const char *path, int first, int last,
+                                         int threads = 0, double flush_seconds = 10)
+{
+    if (n < 1 || n > QUEENS_MAX_N)
+        return 0;
+    std::vector<qtask_t> all;
+    queens_split(n, k < n ? k : n, qtask_t{0, 0, 0, 0}, all);
+    int T = (int)all.size();
+    if (last < 0 || last > T)
+        last = T;
+    if (first < 0)
+        first = 0;
+
+    std::map<int, long long> done;
+    if (!queens_trim_checkpoint(path) || !queens_load_checkpoint(path, n, k, T, done))
+        return -1;
+    FILE *fp = fopen(path, "a");
+    if (!fp)
+        return -1;
+    fseek(fp, 0, SEEK_END);
+    bool werr = ftell(fp) == 0 && fprintf(fp, "queens %d %d %d\n", n, k, T) < 0;
+
+    long long total = 0;
+    std::vector<std::pair<int, qtask_t>> todo;
+    for (int id = first; id < last; id++)
+    {
+        if (done.count(id))
+            total += done[id];
+        else
+            todo.push_back({id, all[id]});
+    }
+
+    // 完成的任务先写进stdio缓冲，每隔flush_seconds秒刷到磁盘
+    std::mutex mu;
+    auto last_flush = std::chrono::steady_clock::now();
+    if (threads <= 0)
+        threads = (int)std::thread::hardware_concurrency();
+    qmask_t full = queens_full(n);
+    ws_pool_t<std::pair<int, qtask_t>> pool(threads);
+    total += pool.run(todo, [&](int, const std::pair<int, qtask_t> &t) -> long long
+                      {
+        long long c = queens_dfs(full, t.second.cols, t.second.ld, t.second.rd);
+        std::lock_guard<std::mutex> lk(mu);
+        if (fprintf(fp, "%d %lld\n", t.first, c) < 0)
+            werr = true;
+        auto now = std::chrono::steady_clock::now();
+        if (std::chrono::duration<double>(now - last_flush).count() >= flush_seconds)
+        {
+            if (fflush(fp) != 0)
+                werr = true;
+            last_flush = now;
+        }
+        return c; });
+    if (fclose(fp) != 0)
+        werr = true;
+    return werr ? -1 : total;
+}
+
+// 合并多个断点文件：所有任务都齐全时返回总解数，否则返回-1并在*missing中给出缺少的任务数
+inline long long queens_merge(const std::vector<const char *> &paths, int *missing = NULL)
+{
+    int n = -1, k = -1, T = -1;
+    std::map<int, long long> done;
+    for (const char *p : paths)
+    {
+        FILE *fp = fopen(p, "r");
+        if (!fp)
+            return -1;
+        int fn, fk, fT;
+        bool ok = fscanf(fp, "queens %d %d %d", &fn, &fk, &fT) == 3;
+        fclose(fp);
+        if (ok && n < 0)
+            n = fn, k = fk, T = fT;
+        if (!ok || fn != n || fk != k || fT != T)
+            return -1;
+        queens_load_checkpoint(p, n, k, T, done);
+    }
+    if (missing)
+        *missing = T - (int)done.size();
+    if ((int)done.size() != T)
+        return -1;
+    long long total = 0;
+    for (auto &e : done)
+        total += e.second;
+    return total;
+}
+
+// ---------------- 部分固定棋盘的补全 ----------------
+// 已固定的皇后先写进掩码，之后每步选合法列最少的行（最少剩余值优先）。
+// 行号不再连续，所以对角线用绝对编号：d1第(r+c)位，d2第(c-r+n-1)位。
+typedef struct qfix_t
+{
+    int n;
+    qmask_t rows, cols; // 已放皇后的行、列
+    uint64_t d1, d2;
+} qfix_t;
+
+// 第r行当前可放的列
+inline qmask_t qfix_avail(const qfix_t &b, int r)
+{
+    return ~b.cols & (qmask_t)(~b.d1 >> r) & (qmask_t)(~b.d2 >> (b.n - 1 - r)) & queens_full(b.n);
+}
+
+inline void qfix_put(qfix_t &b, int r, int c)
+{
+    b.rows |= (qmask_t)1 << r;
+    b.cols |= (qmask_t)1 << c;
+    b.d1 |= (uint64_t)1 << (r + c);
+    b.d2 |= (uint64_t)1 << (c - r + b.n - 1);
+}
+
+inline long long qfix_search(const qfix_t &b, bool first_only, int *q)
+{
+    QUEENS_NODE();
+    if (b.rows == queens_full(b.n))
+        return 1;
+    int best = -1, best_cnt = 33;
+    qmask_t best_avail = 0;
+    qmask_t left = ~b.rows & queens_full(b.n);
+    while (left)
+    {
+        int r = queens_col(left & (0 - left));
+        left &= left - 1;
+        qmask_t a = qfix_avail(b, r);
+        int cnt = __builtin_popcount(a);
+        if (cnt < best_cnt)
+        {
+            best = r, best_cnt = cnt, best_avail = a;
+            if (cnt <= 1)
+                break;
+        }
+    }
+    long long total = 0;
+    while (best_avail)
+    {
+        qmask_t bit = best_avail & (0 - best_avail);
+        best_avail ^= bit;
+        qfix_t nb = b;
+        qfix_put(nb, best, queens_col(bit));
+        q[best] = queens_col(bit);
+        total += qfix_search(nb, first_only, q);
+        if (first_only && total)
+            break;
+    }
+    return total;
+}
+
+// 在已固定 fixed 中皇后的前提下补全棋盘（n <= QUEENS_MAX_N）。
+// first_only 为真时找到一个解就停，q[] 为该解；否则返回补全方式总数。固定的皇后本身冲突时返回-1
+inline long long queens_complete(int n, const std::vector<std::pair<int, int>> &fixed, bool first_only, int *q)
+{
+    if (n < 1 || n > QUEENS_MAX_N)
+        return -1;
+    qfix_t b = {n, 0, 0, 0, 0};
+    for (auto &p : fixed)
+    {
+        int r = p.first, c = p.second;
+        if (r < 0 || r >= n || c < 0 || c >= n || !((qfix_avail(b, r) >> c) & 1) || ((b.rows >> r) & 1))
+            return -1;
+        qfix_put(b, r, c);
+        q[r] = c;
+    }
+    return qfix_search(b, first_only, q);
+}
+
+// ---------------- 编译期固定N的求解器 ----------------
+// 逐行放置，用列/对角线掩码剪枝，只生成列的排列而不是N^N种组合。
+// Row 是模板参数，递归在编译期展开成N层，每层的掩码运算都是常量宽度。
+template <int N>
+struct Queens
+{
+    static constexpr qmask_t FULL = (qmask_t)((1ull << N) - 1);
+
+    // Emit为false时只计数；为true时q[]记录每行的列号，每个解调用fn(q)
+    template <int Row, bool Emit, class Fn>
+    static long long solve(qmask_t cols, qmask_t ld, qmask_t rd, int *q, Fn &fn)
+    {
+        QUEENS_NODE();
+        qmask_t avail = ~(cols | ld | rd) & FULL;
+        if constexpr (Row == N - 1)
+        {
+            // 最后一行只剩一列，可用与否直接决定是否成解
+            if (!avail)
+                return 0;
+            if constexpr (Emit)
+            {
+                q[Row] = queens_col(avail);
+                fn((const int *)q);
+            }
+            return 1;
+        }
+        else
+        {
+            long long cnt = 0;
+            while (avail)
+            {
+                qmask_t bit = avail & (0 - avail);
+                avail ^= bit;
+                if constexpr (Emit)
+                    q[Row] = queens_col(bit);
+                cnt += solve<Row + 1, Emit>(cols | bit, ((ld | bit) << 1) & FULL, (rd | bit) >> 1, q, fn);
+            }
+            return cnt;
+        }
+    }
+
+    static long long count()
+    {
+        auto none = [](const int *) {};
+        return solve<0, false>(0, 0, 0, nullptr, none);
+    }
+
+    template <class Fn>
+    static long long each(Fn fn)
+    {
+        int q[N];
+        return solve<0, true>(0, 0, 0, q, fn);
+    }
+};
+
+#define QUEENS_FIXED_MIN 4
+#define QUEENS_FIXED_MAX 16
+
+template <class Fn, int... I>
+long long queens_dispatch_fixed(int n, bool emit, Fn &fn, std::integer_sequence<int, I...>)
+{
+    long long cnt = -1;
+    ((n == QUEENS_FIXED_MIN + I
+          ? (void)(cnt = emit ? Queens<QUEENS_FIXED_MIN + I>::each(fn) : Queens<QUEENS_FIXED_MIN + I>::count())
+          : (void)0),
+     ...);
+    if (cnt >= 0)
+        return cnt;
+    if (n < 1 || n > QUEENS_MAX_N)
+        return 0;
+    if (!emit)
+        return queens_count(n);
+    int q[QUEENS_MAX_N];
+    return queens_enum_dfs(n, 0, 0, 0, 0, q, fn);
+}
+
+// N在[QUEENS_FIXED_MIN, QUEENS_FIXED_MAX]内时选用对应的 Queens<N>，否则退回运行时N的位运算DFS。
+// emit为真时每个解调用fn(q)
+template <class Fn>
+long long queens_solve_fixed(int n, bool emit, Fn fn)
+{
+    return queens_dispatch_fixed(n, emit, fn, std::make_integer_sequence<int, QUEENS_FIXED_MAX - QUEENS_FIXED_MIN + 1>());
+}
+
+// ---------------- 朴素枚举 ----------------
+// 与原始8重循环相同的做法：枚举 n^n 种每行一列的组合，再整体检查两两冲突，只作为基准对比
+inline long long queens_count_naive(int n)
+{
+    if (n < 1 || n > 10)
+        return -1;
+    int q[10] = {0};
+    long long cnt = 0;
+    while (true)
+    {
+        QUEENS_NODE();
+        bool ok = true;
+        for (int a = 0; a < n && ok; a++)
+            for (int b = a + 1; b < n && ok; b++)
+                if (q[a] == q[b] || q[a] - q[b] == a - b || q[a] - q[b] == b - a)
+                    ok = false;
+        cnt += ok;
+        // 像里程表一样让最后一位加一并进位
+        int r = n - 1;
+        while (r >= 0 && ++q[r] == n)
+            q[r--] = 0;
+        if (r < 0)
+            return cnt;
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+// 数独公共部分：每行、每列、每宫各用一个9位掩码记录已出现的数字
+#include <cstdint>
+#include <vector>
+
+#define SUDOKU_SIZE 9      // 数独尺寸（9×9）
+#define SUDOKU_SUB 3       // 宫的尺寸（3×3）
+#define SUDOKU_ALL 0x1FF   // 数字1..9全部出现的掩码，第d-1位表示数字d
+
+/**
+ * @brief 行/列/宫的已用数字掩码
+ * 某格的候选数字就是三个掩码并集的补集，填数、撤销都是三次位运算；
+ * 候选按从小到大枚举：for (m = cand; m; m &= m - 1) 取 sudoku_digit(m)
+ */
+struct SudokuMask
+{
+    uint16_t row[SUDOKU_SIZE], col[SUDOKU_SIZE], box[SUDOKU_SIZE];
+
+    static int boxOf(int r, int c) { return r / SUDOKU_SUB * SUDOKU_SUB + c / SUDOKU_SUB; }
+
+    /**
+     * @brief 由盘面建立掩码
+     * @return 题面中同一行/列/宫有重复数字时返回false
+     */
+    bool init(const std::vector<std::vector<int>> &board)
+    {
+        for (int i = 0; i < SUDOKU_SIZE; ++i)
+            row[i] = col[i] = box[i] = 0;
+        bool ok = true;
+        for (int r = 0; r < SUDOKU_SIZE; ++r)
+        {
+            for (int c = 0; c < SUDOKU_SIZE; ++c)
+            {
+                int d = board[r][c];
+                if (d == 0)
+                    continue;
+                if (!allowed(r, c, d))
+                    ok = false;
+                place(r, c, d);
+            }
+        }
+        return ok;
+    }
+
+    // (r,c) 处可以填的数字
+    uint16_t candidates(int r, int c) const { return ~(row[r] | col[c] | box[boxOf(r, c)]) & SUDOKU_ALL; }
+    bool allowed(int r, int c, int d) const { return candidates(r, c) >> (d - 1) & 1; }
+
+    void place(int r, int c, int d)
+    {
+        uint16_t m = (uint16_t)(1 << (d - 1));
+        row[r] |= m;
+        col[c] |= m;
+        box[boxOf(r, c)] |= m;
+    }
+    void remove(int r, int c, int d)
+    {
+        uint16_t m = (uint16_t)~(1 << (d - 1));
+        row[r] &= m;
+        col[c] &= m;
+        box[boxOf(r, c)] &= m;
+    }
+};
+
+// 掩码中最小的数字
+inline int sudoku_digit(uint16_t m) { return __builtin_ctz(m) + 1; }